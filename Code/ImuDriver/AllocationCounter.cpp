@@ -0,0 +1,68 @@
+#include "ImuDriver/Common/AllocationCounter.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+thread_local std::uint64_t AllocationsInCurrentThread = 0;
+
+void* Allocate(const std::size_t size, const std::size_t alignment)
+{
+    ++AllocationsInCurrentThread;
+
+    const auto roundedSize = (size + alignment - 1) / alignment * alignment;
+    auto* memory = alignment <= alignof(std::max_align_t)
+        ? std::malloc(size == 0 ? 1 : size)
+        : std::aligned_alloc(alignment, roundedSize == 0 ? alignment : roundedSize);
+    if (not memory)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return memory;
+}
+
+}
+
+namespace Common::Allocations
+{
+
+std::uint64_t CountInCurrentThread()
+{
+    return AllocationsInCurrentThread;
+}
+
+}
+
+void* operator new(const std::size_t size)
+{
+    return Allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return Allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
@@ -0,0 +1,66 @@
+#include "ImuDriver/Implementation/OrientationFusion.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+
+// Measures the time OrientationFusion::Step() takes to advance a fleet of devices by one
+// tick, for each algorithm. Inputs are set once, so only the step itself is measured:
+// gathering the inputs of all devices and the vectorised filter update.
+namespace
+{
+
+constexpr auto NumberOfDevices = std::size_t{64};
+constexpr auto NumberOfSteps = 1'000'000;
+constexpr auto NumberOfRepetitions = 5;
+constexpr auto Period = 0.02f;
+
+void SetNoisyInputs(OrientationFusion& fusion)
+{
+    auto generator = std::mt19937{42};
+    auto acceleration = std::uniform_real_distribution<float>{-0.05f, 0.05f};
+    auto rotation = std::uniform_real_distribution<float>{-5.0f, 5.0f};
+
+    for (std::size_t device = 0; device < fusion.GetNumberOfDevices(); ++device)
+    {
+        fusion.SetInput(device, acceleration(generator), acceleration(generator), 1.0f + acceleration(generator),
+            rotation(generator), rotation(generator), rotation(generator));
+    }
+}
+
+// Best of several runs, in nanoseconds per step of all devices.
+double Measure(const OrientationFusion::Algorithm algorithm, const float gain)
+{
+    auto fusion = OrientationFusion{NumberOfDevices, algorithm, gain};
+    SetNoisyInputs(fusion);
+
+    auto best = std::chrono::duration<double, std::nano>::max();
+    for (int repetition = 0; repetition < NumberOfRepetitions; ++repetition)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < NumberOfSteps; ++step)
+        {
+            fusion.Step(Period);
+        }
+        best = std::min<std::chrono::duration<double, std::nano>>(best, std::chrono::steady_clock::now() - start);
+    }
+    return best.count() / NumberOfSteps;
+}
+
+void Report(const std::string_view name, const double nanosecondsPerStep)
+{
+    std::cout << std::format("{} {:.1f} ns per step of {} devices, {:.2f} ns per device", name, nanosecondsPerStep, NumberOfDevices, nanosecondsPerStep / NumberOfDevices) << std::endl;
+}
+
+}
+
+int main()
+{
+    Report("Complementary:", Measure(OrientationFusion::Algorithm::Complementary, 2.0f));
+    Report("Madgwick:     ", Measure(OrientationFusion::Algorithm::Madgwick, 0.1f));
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "ImuDriver/Implementation/BlackBoxRecorder.hpp"
+#include "ImuDriver/Implementation/FreeFallDetector.hpp"
+#include "ImuDriver/Implementation/FreeFallLogger.hpp"
+#include "ImuDriver/Implementation/Pipeline.hpp"
+#include "ImuDriver/Implementation/VirtualClock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Compares the cost per sample of the same stages (free fall detection and black box
+// recording) composed as a Pipeline and wired through observer interfaces. The stages
+// are defined out of line, so they are only inlined into the pipeline when built with
+// IMU_DRIVER_ENABLE_LTO.
+namespace
+{
+
+constexpr auto NumberOfSamples = std::size_t{10'000'000};
+constexpr auto NumberOfRepetitions = 5;
+constexpr auto NumberOfDistinctSamples = std::size_t{4096};
+
+// As in main. The input never falls, so no dump is written.
+constexpr auto BlackBoxConfiguration = BlackBoxRecorder::Configuration{
+    .preTriggerSamples = 100,
+    .postTriggerSamples = 50,
+};
+
+using Samples = std::vector<std::array<float, 6>>;
+
+Samples NoiseAroundGravity()
+{
+    auto generator = std::mt19937{42};
+    auto noise = std::uniform_real_distribution<float>{-0.05f, 0.05f};
+
+    auto samples = Samples(NumberOfDistinctSamples);
+    for (auto& sample : samples)
+    {
+        std::ranges::generate(sample, [&] { return noise(generator); });
+        sample[2] += 1.0f;
+    }
+    return samples;
+}
+
+// Delivers samples the way ImuDriver does, through the observers it is subscribed with.
+class Source
+{
+public:
+    Interface::ImuDriver::NewDataAcquiredObserver* newDataAcquiredObserver = nullptr;
+    Interface::ImuDriver::NewMotionDataAcquiredObserver* newMotionDataAcquiredObserver = nullptr;
+
+    [[gnu::noinline]] void Deliver(const Samples& samples) const
+    {
+        for (std::size_t n = 0; n < NumberOfSamples; ++n)
+        {
+            const auto& [ax, ay, az, gx, gy, gz] = samples[n % samples.size()];
+            if (newDataAcquiredObserver)
+            {
+                newDataAcquiredObserver->OnNewDataAcquired(ax, ay, az);
+            }
+            if (newMotionDataAcquiredObserver)
+            {
+                newMotionDataAcquiredObserver->OnNewMotionDataAcquired(ax, ay, az, gx, gy, gz);
+            }
+        }
+    }
+};
+
+// Best of several runs, in nanoseconds per sample.
+double Measure(const Source& source, const Samples& samples)
+{
+    auto best = std::chrono::duration<double, std::nano>::max();
+    for (int repetition = 0; repetition < NumberOfRepetitions; ++repetition)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        source.Deliver(samples);
+        best = std::min<std::chrono::duration<double, std::nano>>(best, std::chrono::steady_clock::now() - start);
+    }
+    return best.count() / NumberOfSamples;
+}
+
+double MeasureObservers(const Samples& samples)
+{
+    auto clock = VirtualClock{};
+    auto freeFallDetector = FreeFallDetector{};
+    auto freeFallLogger = FreeFallLogger{};
+    auto blackBoxRecorder = BlackBoxRecorder{clock, BlackBoxConfiguration};
+    freeFallDetector.SubscribeToFreeFallDetection(freeFallLogger);
+    freeFallDetector.SubscribeToFreeFallDetection(blackBoxRecorder);
+
+    const auto source = Source{
+        .newDataAcquiredObserver = &freeFallDetector,
+        .newMotionDataAcquiredObserver = &blackBoxRecorder,
+    };
+    return Measure(source, samples);
+}
+
+double MeasurePipeline(const Samples& samples)
+{
+    auto clock = VirtualClock{};
+    auto freeFallDetector = FreeFallDetector{};
+    auto freeFallLogger = FreeFallLogger{};
+    auto blackBoxRecorder = BlackBoxRecorder{clock, BlackBoxConfiguration};
+    freeFallDetector.SubscribeToFreeFallDetection(freeFallLogger);
+    freeFallDetector.SubscribeToFreeFallDetection(blackBoxRecorder);
+    auto pipeline = Pipeline{freeFallDetector, blackBoxRecorder};
+
+    const auto source = Source{
+        .newMotionDataAcquiredObserver = &pipeline,
+    };
+    return Measure(source, samples);
+}
+
+}
+
+int main()
+{
+    const auto samples = NoiseAroundGravity();
+    const auto observers = MeasureObservers(samples);
+    const auto pipeline = MeasurePipeline(samples);
+
+    std::cout << std::format("Observers: {:.2f} ns per sample", observers) << std::endl;
+    std::cout << std::format("Pipeline:  {:.2f} ns per sample", pipeline) << std::endl;
+    return 0;
+}
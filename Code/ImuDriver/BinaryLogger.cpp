@@ -0,0 +1,293 @@
+#include "ImuDriver/Common/BinaryLogger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Log::Binary::Detail
+{
+
+namespace
+{
+
+constexpr std::size_t QueueCapacity = 1024;
+static_assert((QueueCapacity & (QueueCapacity - 1)) == 0, "Queue capacity has to be a power of two");
+
+constexpr auto WriterPollingPeriod = std::chrono::milliseconds{10};
+
+struct MessageRecord
+{
+    FormatId id;
+    std::uint16_t size;
+    std::int64_t timestamp;
+    std::array<std::byte, MaxArgumentsSize> arguments;
+};
+
+struct FormatDefinition
+{
+    Level level;
+    std::string format;
+    std::vector<ArgumentType> arguments;
+};
+
+// Kept apart from the Writer, so that registering formats during static initialisation
+// neither opens the log file nor starts a thread.
+class FormatRegistry
+{
+public:
+    FormatId Register(const Level level, const std::string_view format, const std::span<const ArgumentType> arguments)
+    {
+        const auto lock = std::lock_guard{m_Mutex};
+        m_Definitions.push_back({level, std::string{format}, {arguments.begin(), arguments.end()}});
+        return static_cast<FormatId>(m_Definitions.size() - 1);
+    }
+
+    // Calls `visit` with the ID and definition of every format from `first` on, returns
+    // the number of formats.
+    template<typename Visitor>
+    std::size_t VisitFrom(const std::size_t first, Visitor visit)
+    {
+        const auto lock = std::lock_guard{m_Mutex};
+        for (auto id = first; id < m_Definitions.size(); ++id)
+        {
+            visit(static_cast<FormatId>(id), m_Definitions[id]);
+        }
+        return m_Definitions.size();
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::vector<FormatDefinition> m_Definitions;
+};
+
+FormatRegistry& GetFormatRegistry()
+{
+    static auto registry = FormatRegistry{};
+    return registry;
+}
+
+// Bounded multi-producer queue (each slot's sequence number tells whose turn it is),
+// drained by a single writer thread which owns the log file.
+class Writer
+{
+public:
+    Writer()
+        : m_Formats{GetFormatRegistry()}
+    {
+        for (std::size_t i = 0; i < QueueCapacity; ++i)
+        {
+            m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_Thread = std::jthread{[this](std::stop_token stopToken) { Run(stopToken); }};
+    }
+
+    ~Writer()
+    {
+        m_Thread.request_stop();
+        m_Thread.join();
+    }
+
+    void Configure(const Interface::Clock& clock, const OverflowPolicy overflowPolicy)
+    {
+        m_OverflowPolicy.store(overflowPolicy, std::memory_order_relaxed);
+        m_Clock.store(&clock, std::memory_order_release);
+    }
+
+    void Push(const FormatId id, const std::byte* arguments, const std::size_t size)
+    {
+        auto position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true)
+        {
+            slot = &m_Slots[position % QueueCapacity];
+            const auto sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0)
+            {
+                if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                if (m_OverflowPolicy.load(std::memory_order_relaxed) == OverflowPolicy::Drop)
+                {
+                    m_DroppedRecords.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::yield();
+                position = m_EnqueuePosition.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                position = m_EnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        auto& record = slot->record;
+        record.id = id;
+        record.size = static_cast<std::uint16_t>(size);
+        record.timestamp = Now();
+        std::memcpy(record.arguments.data(), arguments, size);
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        MessageRecord record;
+    };
+
+    std::int64_t Now() const
+    {
+        const auto* clock = m_Clock.load(std::memory_order_acquire);
+        const auto now = clock ? clock->Now() : std::chrono::time_point_cast<Interface::Clock::Duration>(std::chrono::steady_clock::now());
+        return now.time_since_epoch().count();
+    }
+
+    void Run(const std::stop_token stopToken)
+    {
+        while (not stopToken.stop_requested())
+        {
+            if (not Drain())
+            {
+                Flush();
+                std::this_thread::sleep_for(WriterPollingPeriod);
+            }
+        }
+
+        while (Drain())
+        {
+        }
+        Flush();
+    }
+
+    // Starts the session on the first record, so that nothing is written before.
+    void Open()
+    {
+        m_File.open(FileName, std::ios::binary | std::ios::app);
+        m_File.write(FileMagic.data(), FileMagic.size());
+        WriteValue(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        WriteValue(Now());
+    }
+
+    void Flush()
+    {
+        if (m_File.is_open())
+        {
+            m_File.flush();
+        }
+    }
+
+    // Returns false when there was nothing to write.
+    bool Drain()
+    {
+        auto& slot = m_Slots[m_DequeuePosition % QueueCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1)
+        {
+            ReportDroppedRecords();
+            return false;
+        }
+
+        if (not m_File.is_open())
+        {
+            Open();
+        }
+
+        const auto& record = slot.record;
+        WriteDefinitionsUpTo(record.id);
+
+        WriteValue(RecordKind::Message);
+        WriteValue(record.id);
+        WriteValue(record.timestamp);
+        m_File.write(reinterpret_cast<const char*>(record.arguments.data()), record.size);
+
+        slot.sequence.store(m_DequeuePosition + QueueCapacity, std::memory_order_release);
+        ++m_DequeuePosition;
+        return true;
+    }
+
+    void WriteDefinitionsUpTo(const FormatId id)
+    {
+        if (id < m_WrittenDefinitions)
+        {
+            return;
+        }
+
+        m_WrittenDefinitions = m_Formats.VisitFrom(m_WrittenDefinitions, [this](const FormatId id, const FormatDefinition& definition)
+        {
+            WriteValue(RecordKind::FormatDefinition);
+            WriteValue(id);
+            WriteValue(definition.level);
+            WriteValue(static_cast<std::uint8_t>(definition.arguments.size()));
+            m_File.write(reinterpret_cast<const char*>(definition.arguments.data()), definition.arguments.size());
+            WriteValue(static_cast<std::uint16_t>(definition.format.size()));
+            m_File.write(definition.format.data(), definition.format.size());
+        });
+    }
+
+    void ReportDroppedRecords()
+    {
+        if (const auto dropped = m_DroppedRecords.exchange(0, std::memory_order_relaxed); dropped != 0)
+        {
+            Log::Error(std::format("Binary log queue full, {} records dropped", dropped));
+        }
+    }
+
+    template<typename T>
+    void WriteValue(const T& value)
+    {
+        m_File.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::array<Slot, QueueCapacity> m_Slots;
+    alignas(64) std::atomic<std::size_t> m_EnqueuePosition = 0;
+    alignas(64) std::size_t m_DequeuePosition = 0;
+    std::atomic<std::size_t> m_DroppedRecords = 0;
+
+    std::atomic<const Interface::Clock*> m_Clock = nullptr;
+    std::atomic<OverflowPolicy> m_OverflowPolicy = OverflowPolicy::Drop;
+
+    FormatRegistry& m_Formats;
+    std::size_t m_WrittenDefinitions = 0;
+
+    std::ofstream m_File;
+    std::jthread m_Thread;
+};
+
+Writer& GetWriter()
+{
+    static auto writer = Writer{};
+    return writer;
+}
+
+}
+
+FormatId RegisterFormat(const Level level, const std::string_view format, const std::span<const ArgumentType> arguments)
+{
+    return GetFormatRegistry().Register(level, format, arguments);
+}
+
+void Write(const FormatId id, const std::byte* arguments, const std::size_t size)
+{
+    GetWriter().Push(id, arguments, size);
+}
+
+}
+
+namespace Log::Binary
+{
+
+void Configure(Interface::Clock& clock, const OverflowPolicy overflowPolicy)
+{
+    Detail::GetWriter().Configure(clock, overflowPolicy);
+}
+
+}
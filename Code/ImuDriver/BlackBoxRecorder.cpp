@@ -0,0 +1,166 @@
+#include "ImuDriver/Implementation/BlackBoxRecorder.hpp"
+
+#include "ImuDriver/Common/BinaryLogger.hpp"
+#include "ImuDriver/Common/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+namespace
+{
+
+std::string DumpFileName(const std::size_t dumpNumber)
+{
+    return std::format("{}{}.bin", BlackBoxRecorder::FileNamePrefix, dumpNumber);
+}
+
+}
+
+BlackBoxRecorder::BlackBoxRecorder(Interface::Clock& clock, const Configuration configuration)
+    : m_Clock{clock}
+    , m_Configuration{configuration}
+    , m_Ring(configuration.preTriggerSamples + configuration.postTriggerSamples)
+    , m_Dump(m_Ring.size())
+{
+    m_WriterThread = std::jthread{[this] { WriterThread(); }};
+}
+
+BlackBoxRecorder::~BlackBoxRecorder()
+{
+    // A pending dump is written out before the writer thread is stopped.
+    auto state = DumpState::Idle;
+    while (not m_DumpState.compare_exchange_weak(state, DumpState::Stopping, std::memory_order_acq_rel))
+    {
+        m_DumpState.wait(DumpState::Pending, std::memory_order_acquire);
+        state = DumpState::Idle;
+    }
+    m_DumpState.notify_all();
+    m_WriterThread.join();
+}
+
+void BlackBoxRecorder::Process(const MotionSample& sample)
+{
+    Record(sample);
+}
+
+void BlackBoxRecorder::OnNewMotionDataAcquired(const float ax, const float ay, const float az, const float gx, const float gy, const float gz)
+{
+    Record({{ax, ay, az}, {gx, gy, gz}});
+}
+
+// Free fall is detected before the sample which completed the detection is recorded,
+// so that sample is the first one of the post-trigger window.
+void BlackBoxRecorder::OnFreeFallStarted()
+{
+    Trigger();
+}
+
+void BlackBoxRecorder::OnFreeFallFinished()
+{
+}
+
+void BlackBoxRecorder::Record(const MotionSample& sample)
+{
+    if (m_Ring.empty())
+    {
+        return;
+    }
+
+    const auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(m_Clock.Now().time_since_epoch());
+    m_Ring[m_NextSample] = {timestamp.count(), sample.acceleration, sample.rotation};
+    m_NextSample = (m_NextSample + 1) % m_Ring.size();
+    m_NumberOfStoredSamples = std::min(m_NumberOfStoredSamples + 1, m_Ring.size());
+
+    if (m_IsCapturing and --m_RemainingPostTriggerSamples == 0)
+    {
+        HandOverDump();
+    }
+}
+
+void BlackBoxRecorder::Trigger()
+{
+    if (m_IsCapturing or m_Ring.empty())
+    {
+        return;
+    }
+
+    m_IsCapturing = true;
+    m_PreTriggerSamples = std::min(m_NumberOfStoredSamples, m_Configuration.preTriggerSamples);
+    m_RemainingPostTriggerSamples = m_Configuration.postTriggerSamples;
+    if (m_RemainingPostTriggerSamples == 0)
+    {
+        HandOverDump();
+    }
+}
+
+void BlackBoxRecorder::HandOverDump()
+{
+    m_IsCapturing = false;
+    if (m_DumpState.load(std::memory_order_acquire) != DumpState::Idle)
+    {
+        Log::Binary::Error<"Black box dump dropped, the previous one is still being written">();
+        return;
+    }
+
+    const auto size = m_PreTriggerSamples + m_Configuration.postTriggerSamples;
+    const auto first = (m_NextSample + m_Ring.size() - size) % m_Ring.size();
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        m_Dump[i] = m_Ring[(first + i) % m_Ring.size()];
+    }
+    m_DumpSize = size;
+    m_DumpTriggerIndex = m_PreTriggerSamples;
+
+    m_DumpState.store(DumpState::Pending, std::memory_order_release);
+    m_DumpState.notify_all();
+}
+
+// Dumps of earlier runs are kept: each dump gets the lowest number not taken by a file yet.
+void BlackBoxRecorder::WriterThread()
+{
+    auto dumpNumber = std::size_t{0};
+    while (true)
+    {
+        m_DumpState.wait(DumpState::Idle, std::memory_order_acquire);
+        if (m_DumpState.load(std::memory_order_acquire) == DumpState::Stopping)
+        {
+            return;
+        }
+
+        while (std::filesystem::exists(DumpFileName(dumpNumber)))
+        {
+            ++dumpNumber;
+        }
+        WriteDump(DumpFileName(dumpNumber++));
+        m_DumpState.store(DumpState::Idle, std::memory_order_release);
+        m_DumpState.notify_all();
+    }
+}
+
+void BlackBoxRecorder::WriteDump(const std::string& fileName) const
+{
+    auto file = std::ofstream{fileName, std::ios::binary};
+
+    const auto numberOfSamples = static_cast<std::uint32_t>(m_DumpSize);
+    const auto triggerIndex = static_cast<std::uint32_t>(m_DumpTriggerIndex);
+    file.write(FileMagic.data(), FileMagic.size());
+    file.write(reinterpret_cast<const char*>(&numberOfSamples), sizeof(numberOfSamples));
+    file.write(reinterpret_cast<const char*>(&triggerIndex), sizeof(triggerIndex));
+    for (std::size_t i = 0; i < m_DumpSize; ++i)
+    {
+        const auto& sample = m_Dump[i];
+        file.write(reinterpret_cast<const char*>(&sample.timestamp), sizeof(sample.timestamp));
+        file.write(reinterpret_cast<const char*>(sample.acceleration.data()), sizeof(sample.acceleration));
+        file.write(reinterpret_cast<const char*>(sample.rotation.data()), sizeof(sample.rotation));
+    }
+
+    if (not file)
+    {
+        Log::Error(std::format("Writing black box dump to {} failed", fileName));
+        return;
+    }
+    Log::Info(std::format("Black box dump of {} samples written to {}", m_DumpSize, fileName));
+}
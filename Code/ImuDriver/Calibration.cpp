@@ -0,0 +1,65 @@
+#include "ImuDriver/Implementation/Calibration.hpp"
+
+#include <fstream>
+#include <limits>
+
+namespace
+{
+
+constexpr auto Sensors = std::array{"accelerometer", "gyroscope"};
+
+}
+
+ImuCalibration::Status ImuCalibration::Save(const std::string& path) const
+{
+    auto file = std::ofstream{path};
+    file.precision(std::numeric_limits<float>::max_digits10);
+    const auto calibrations = std::array{&accelerometer, &gyroscope};
+    for (std::size_t sensor = 0; sensor < calibrations.size(); ++sensor)
+    {
+        const auto& [offset, gain] = *calibrations[sensor];
+        file << Sensors[sensor] << " offset " << offset[0] << ' ' << offset[1] << ' ' << offset[2] << '\n';
+        file << Sensors[sensor] << " gain " << gain[0] << ' ' << gain[1] << ' ' << gain[2] << '\n';
+    }
+
+    return file ? Status::Success : Status::FileError;
+}
+
+std::pair<ImuCalibration::Status, ImuCalibration> ImuCalibration::Load(const std::string& path)
+{
+    auto result = std::pair<Status, ImuCalibration>{Status::FileError, {}};
+    auto& [status, calibration] = result;
+
+    auto file = std::ifstream{path};
+    const auto calibrations = std::array{&calibration.accelerometer, &calibration.gyroscope};
+    for (std::size_t sensor = 0; sensor < calibrations.size(); ++sensor)
+    {
+        for (auto* values : {&calibrations[sensor]->offset, &calibrations[sensor]->gain})
+        {
+            auto sensorName = std::string{};
+            auto valuesName = std::string{};
+            file >> sensorName >> valuesName >> (*values)[0] >> (*values)[1] >> (*values)[2];
+            if (not file or sensorName != Sensors[sensor])
+            {
+                return result;
+            }
+        }
+    }
+
+    status = Status::Success;
+    return result;
+}
+
+Conversion::Conversion(const float sensitivity, const Calibration& calibration)
+{
+    for (std::size_t axis = 0; axis < m_Scale.size(); ++axis)
+    {
+        m_Scale[axis] = calibration.gain[axis] / sensitivity;
+        m_Offset[axis] = -calibration.gain[axis] * calibration.offset[axis];
+    }
+}
+
+float Conversion::Apply(const std::size_t axis, const std::int16_t raw) const
+{
+    return static_cast<float>(raw) * m_Scale[axis] + m_Offset[axis];
+}
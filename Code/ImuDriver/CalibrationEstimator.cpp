@@ -0,0 +1,141 @@
+#include "ImuDriver/Implementation/CalibrationEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// The IMU is considered stationary when it measures only gravity and (almost) no rotation.
+constexpr auto GravityTolerance = 0.1f;
+constexpr auto RotationTolerance = 10.0f;
+
+// An axis is taken as pointing up or down when it measures most of the gravity.
+constexpr auto AlignedAxisLimit = 0.8f;
+
+constexpr auto MinimumSamplesPerPose = std::uint64_t{25};
+
+}
+
+void CalibrationEstimator::BeginCapture()
+{
+    *this = CalibrationEstimator{};
+    m_IsCapturing = true;
+}
+
+void CalibrationEstimator::EndCapture()
+{
+    m_IsCapturing = false;
+}
+
+bool CalibrationEstimator::IsCapturing() const
+{
+    return m_IsCapturing;
+}
+
+void CalibrationEstimator::Process(const MotionSample& sample)
+{
+    const auto& [ax, ay, az] = sample.acceleration;
+    const auto& [gx, gy, gz] = sample.rotation;
+    OnNewMotionDataAcquired(ax, ay, az, gx, gy, gz);
+}
+
+ImuCalibration CalibrationEstimator::GetEstimate() const
+{
+    auto estimate = ImuCalibration{};
+
+    for (std::size_t axis = 0; axis < m_Accelerometer.size(); ++axis)
+    {
+        const auto& [up, down, horizontal] = m_Accelerometer[axis];
+        auto& offset = estimate.accelerometer.offset[axis];
+        auto& gain = estimate.accelerometer.gain[axis];
+
+        if (up.IsReliable() and down.IsReliable())
+        {
+            offset = static_cast<float>((up.Get() + down.Get()) / 2);
+            gain = static_cast<float>(2 / (up.Get() - down.Get()));
+        }
+        else if (horizontal.IsReliable())
+        {
+            offset = static_cast<float>(horizontal.Get());
+        }
+        else if (up.IsReliable())
+        {
+            offset = static_cast<float>(up.Get() - 1);
+        }
+        else if (down.IsReliable())
+        {
+            offset = static_cast<float>(down.Get() + 1);
+        }
+    }
+
+    for (std::size_t axis = 0; axis < m_Gyroscope.size(); ++axis)
+    {
+        if (m_Gyroscope[axis].IsReliable())
+        {
+            estimate.gyroscope.offset[axis] = static_cast<float>(m_Gyroscope[axis].Get());
+        }
+    }
+
+    return estimate;
+}
+
+std::uint64_t CalibrationEstimator::GetNumberOfStationarySamples() const
+{
+    return m_NumberOfStationarySamples;
+}
+
+void CalibrationEstimator::OnNewMotionDataAcquired(const float ax, const float ay, const float az, const float gx, const float gy, const float gz)
+{
+    if (not m_IsCapturing)
+    {
+        return;
+    }
+
+    const auto acceleration = std::array{ax, ay, az};
+    const auto rotation = std::array{gx, gy, gz};
+
+    const auto gravity = std::hypot(ax, ay, az);
+    const auto isRotating = std::ranges::any_of(rotation, [](const float value) { return std::abs(value) > RotationTolerance; });
+    if (std::abs(gravity - 1.0f) > GravityTolerance or isRotating)
+    {
+        return;
+    }
+    ++m_NumberOfStationarySamples;
+
+    for (std::size_t axis = 0; axis < acceleration.size(); ++axis)
+    {
+        const auto value = acceleration[axis];
+        auto& poses = m_Accelerometer[axis];
+        if (value > AlignedAxisLimit)
+        {
+            poses.up.Add(value);
+        }
+        else if (value < -AlignedAxisLimit)
+        {
+            poses.down.Add(value);
+        }
+        else if (std::abs(value) < 1.0f - AlignedAxisLimit)
+        {
+            poses.horizontal.Add(value);
+        }
+
+        m_Gyroscope[axis].Add(rotation[axis]);
+    }
+}
+
+void CalibrationEstimator::RunningMean::Add(const double value)
+{
+    ++m_Count;
+    m_Mean += (value - m_Mean) / static_cast<double>(m_Count);
+}
+
+bool CalibrationEstimator::RunningMean::IsReliable() const
+{
+    return m_Count >= MinimumSamplesPerPose;
+}
+
+double CalibrationEstimator::RunningMean::Get() const
+{
+    return m_Mean;
+}
@@ -0,0 +1,372 @@
+#include "ImuDriver/Implementation/DecimationFilter.hpp"
+
+#include "ImuDriver/Common/Logger.hpp"
+#include "ImuDriver/Common/Simd.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <span>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace Common;
+
+namespace
+{
+
+constexpr auto NumberOfAxes = std::size_t{3};
+constexpr auto OutputSamplesPerBlock = std::size_t{8};
+
+// CIC works on integers, so samples are converted to fixed point first. One LSB of
+// 1/2048 g keeps the full 16 g range within 16 bits, like the raw sensor output, and
+// one LSB of 1/16 dps the full 2000 dps range. Indexed by accelerations, angular rates.
+constexpr auto FixedPointScales = std::array{2048.0f, 16.0f};
+constexpr auto FixedPointBits = 16;
+constexpr auto RegisterBits = 32;
+constexpr auto MaxNumberOfCicStages = 5;
+constexpr auto CicLanes = std::size_t{4};
+
+std::vector<float> DesignLowPassTaps(const int numberOfTaps, const int decimationFactor)
+{
+    const auto cutoff = 0.5 / decimationFactor;
+    const auto center = (numberOfTaps - 1) / 2.0;
+
+    auto taps = std::vector<float>(numberOfTaps);
+    for (int i = 0; i < numberOfTaps; ++i)
+    {
+        const auto t = i - center;
+        const auto sinc = t == 0.0 ? 1.0 : std::sin(2 * std::numbers::pi * cutoff * t) / (2 * std::numbers::pi * cutoff * t);
+        const auto window = numberOfTaps == 1 ? 1.0 : 0.54 - 0.46 * std::cos(2 * std::numbers::pi * i / (numberOfTaps - 1));
+        taps[i] = static_cast<float>(2 * cutoff * sinc * window);
+    }
+
+    // Unity gain at DC, so gravity passes through unchanged.
+    const auto sum = std::accumulate(taps.begin(), taps.end(), 0.0f);
+    for (auto& tap : taps)
+    {
+        tap /= sum;
+    }
+
+    return taps;
+}
+
+void FirScalar(const float* input, const std::vector<float>& reversedTaps, const std::size_t decimationFactor, float* output)
+{
+    for (std::size_t m = 0; m < OutputSamplesPerBlock; ++m)
+    {
+        const auto* window = input + m * decimationFactor + decimationFactor - 1;
+        auto sum = 0.0f;
+        for (std::size_t j = 0; j < reversedTaps.size(); ++j)
+        {
+            sum += reversedTaps[j] * window[j];
+        }
+        output[m] = sum;
+    }
+}
+
+void FirSimd(const float* input, const std::vector<float>& reversedTaps, const std::size_t decimationFactor, float* output)
+{
+    for (std::size_t m = 0; m < OutputSamplesPerBlock; ++m)
+    {
+        const auto* window = input + m * decimationFactor + decimationFactor - 1;
+        auto sum = Simd::Zero();
+        for (std::size_t j = 0; j < reversedTaps.size(); j += Simd::Width)
+        {
+            sum = Simd::MultiplyAdd(Simd::Load(reversedTaps.data() + j), Simd::Load(window + j), sum);
+        }
+        output[m] = Simd::HorizontalSum(sum);
+    }
+}
+
+using CicInput = std::span<const std::vector<float>, NumberOfAxes>;
+using CicOutput = std::span<std::vector<float>, NumberOfAxes>;
+
+// Filters the three axes of one vector quantity. Integer overflow in the integrators is
+// intended: with modular arithmetic the combs recover the correct result as long as the
+// output itself fits into the register.
+void CicScalar(
+    const CicInput input,
+    const std::size_t blockSize,
+    const std::size_t decimationFactor,
+    const std::size_t numberOfStages,
+    const float fixedPointScale,
+    std::uint32_t* integrators,
+    std::uint32_t* combs,
+    const CicOutput output)
+{
+    const auto gain = fixedPointScale * std::pow(static_cast<float>(decimationFactor), static_cast<float>(numberOfStages));
+
+    for (std::size_t axis = 0; axis < NumberOfAxes; ++axis)
+    {
+        for (std::size_t n = 0; n < blockSize; ++n)
+        {
+            auto value = static_cast<std::uint32_t>(static_cast<std::int32_t>(std::lrint(input[axis][n] * fixedPointScale)));
+            for (std::size_t stage = 0; stage < numberOfStages; ++stage)
+            {
+                auto& integrator = integrators[stage * CicLanes + axis];
+                integrator += value;
+                value = integrator;
+            }
+
+            if (n % decimationFactor != decimationFactor - 1)
+            {
+                continue;
+            }
+
+            for (std::size_t stage = 0; stage < numberOfStages; ++stage)
+            {
+                auto& comb = combs[stage * CicLanes + axis];
+                const auto delayed = comb;
+                comb = value;
+                value -= delayed;
+            }
+            output[axis][n / decimationFactor] = static_cast<float>(static_cast<std::int32_t>(value)) / gain;
+        }
+    }
+}
+
+#if defined(__SSE2__)
+
+// Same as CicScalar, but runs all axes at once in the lanes of one SSE register.
+void CicSimd(
+    const CicInput input,
+    const std::size_t blockSize,
+    const std::size_t decimationFactor,
+    const std::size_t numberOfStages,
+    const float fixedPointScale,
+    std::uint32_t* integrators,
+    std::uint32_t* combs,
+    const CicOutput output)
+{
+    __m128i integratorLanes[MaxNumberOfCicStages];
+    __m128i combLanes[MaxNumberOfCicStages];
+    for (std::size_t stage = 0; stage < numberOfStages; ++stage)
+    {
+        integratorLanes[stage] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(integrators + stage * CicLanes));
+        combLanes[stage] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(combs + stage * CicLanes));
+    }
+
+    const auto scale = _mm_set1_ps(fixedPointScale);
+    const auto gain = _mm_set1_ps(fixedPointScale * std::pow(static_cast<float>(decimationFactor), static_cast<float>(numberOfStages)));
+
+    for (std::size_t n = 0; n < blockSize; ++n)
+    {
+        const auto sample = _mm_set_ps(0.0f, input[2][n], input[1][n], input[0][n]);
+        auto value = _mm_cvtps_epi32(_mm_mul_ps(sample, scale));
+        for (std::size_t stage = 0; stage < numberOfStages; ++stage)
+        {
+            integratorLanes[stage] = _mm_add_epi32(integratorLanes[stage], value);
+            value = integratorLanes[stage];
+        }
+
+        if (n % decimationFactor != decimationFactor - 1)
+        {
+            continue;
+        }
+
+        for (std::size_t stage = 0; stage < numberOfStages; ++stage)
+        {
+            const auto delayed = combLanes[stage];
+            combLanes[stage] = value;
+            value = _mm_sub_epi32(value, delayed);
+        }
+
+        auto converted = std::array<float, CicLanes>{};
+        _mm_storeu_ps(converted.data(), _mm_div_ps(_mm_cvtepi32_ps(value), gain));
+        for (std::size_t axis = 0; axis < NumberOfAxes; ++axis)
+        {
+            output[axis][n / decimationFactor] = converted[axis];
+        }
+    }
+
+    for (std::size_t stage = 0; stage < numberOfStages; ++stage)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(integrators + stage * CicLanes), integratorLanes[stage]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(combs + stage * CicLanes), combLanes[stage]);
+    }
+}
+
+#else
+
+constexpr auto CicSimd = CicScalar;
+
+#endif
+
+}
+
+DecimationFilter::DecimationFilter()
+{
+    Configure(Configuration{});
+}
+
+DecimationFilter::Status DecimationFilter::Configure(const Configuration& configuration)
+{
+    if (configuration.decimationFactor < 1 or configuration.numberOfTaps < 1)
+    {
+        Log::Error("Decimation factor and number of taps have to be positive");
+        return Status::InvalidConfiguration;
+    }
+
+    if (configuration.type == Type::CascadedIntegratorComb)
+    {
+        if (configuration.numberOfStages < 1 or configuration.numberOfStages > MaxNumberOfCicStages)
+        {
+            Log::Error(std::format("CIC supports from 1 to {} stages", MaxNumberOfCicStages));
+            return Status::InvalidConfiguration;
+        }
+
+        const auto bitGrowth = configuration.numberOfStages * std::bit_width(static_cast<unsigned>(configuration.decimationFactor - 1));
+        if (FixedPointBits + bitGrowth > RegisterBits)
+        {
+            Log::Error("CIC decimation factor too large for the number of stages");
+            return Status::InvalidConfiguration;
+        }
+    }
+
+    m_Configuration = configuration;
+    const auto decimationFactor = static_cast<std::size_t>(configuration.decimationFactor);
+    m_BlockSize = OutputSamplesPerBlock * decimationFactor;
+    m_SamplesInBlock = 0;
+
+    m_ReversedTaps.clear();
+    m_HistorySize = 0;
+    if (configuration.type == Type::FiniteImpulseResponse)
+    {
+        const auto taps = DesignLowPassTaps(configuration.numberOfTaps, configuration.decimationFactor);
+        m_ReversedTaps.assign(Simd::PaddedSize(taps.size()) - taps.size(), 0.0f);
+        m_ReversedTaps.insert(m_ReversedTaps.end(), taps.rbegin(), taps.rend());
+        m_HistorySize = m_ReversedTaps.size() - 1;
+    }
+
+    for (auto& axis : m_Input)
+    {
+        axis.assign(m_HistorySize + m_BlockSize, 0.0f);
+    }
+    for (auto& axis : m_Output)
+    {
+        axis.assign(OutputSamplesPerBlock, 0.0f);
+    }
+
+    const auto cicStateSize = configuration.type == Type::CascadedIntegratorComb ? FixedPointScales.size() * configuration.numberOfStages * CicLanes : 0;
+    m_Integrators.assign(cicStateSize, 0);
+    m_Combs.assign(cicStateSize, 0);
+
+    return Status::Success;
+}
+
+void DecimationFilter::SubscribeToNewDataAcquired(NewDataAcquiredObserver& observer)
+{
+    if (m_NewDataAcquiredObserver)
+    {
+        Log::Error("Current implementation supports only one subscriber");
+        return;
+    }
+
+    m_NewDataAcquiredObserver = &observer;
+}
+
+void DecimationFilter::SubscribeToNewMotionDataAcquired(NewMotionDataAcquiredObserver& observer)
+{
+    if (m_NewMotionDataAcquiredObserver)
+    {
+        Log::Error("Current implementation supports only one subscriber");
+        return;
+    }
+
+    m_NewMotionDataAcquiredObserver = &observer;
+}
+
+void DecimationFilter::Process(const MotionSample& sample)
+{
+    const auto& [acceleration, rotation] = sample;
+    const auto position = m_HistorySize + m_SamplesInBlock;
+    for (std::size_t axis = 0; axis < NumberOfAxes; ++axis)
+    {
+        m_Input[axis][position] = acceleration[axis];
+        m_Input[NumberOfAxes + axis][position] = rotation[axis];
+    }
+
+    if (++m_SamplesInBlock < m_BlockSize)
+    {
+        return;
+    }
+    m_SamplesInBlock = 0;
+
+    // Nobody receives angular rates without a motion data observer, so they are not filtered.
+    const auto numberOfChannels = m_NewMotionDataAcquiredObserver ? NumberOfChannels : NumberOfAxes;
+    switch (m_Configuration.type)
+    {
+    case Type::FiniteImpulseResponse:  FilterBlockWithFir(numberOfChannels); break;
+    case Type::CascadedIntegratorComb: FilterBlockWithCic(numberOfChannels); break;
+    }
+
+    PublishOutputBlock();
+}
+
+void DecimationFilter::OnNewDataAcquired(const float ax, const float ay, const float az)
+{
+    Process({{ax, ay, az}, {0.0f, 0.0f, 0.0f}});
+}
+
+void DecimationFilter::OnNewMotionDataAcquired(const float ax, const float ay, const float az, const float gx, const float gy, const float gz)
+{
+    Process({{ax, ay, az}, {gx, gy, gz}});
+}
+
+void DecimationFilter::FilterBlockWithFir(const std::size_t numberOfChannels)
+{
+    const auto decimationFactor = static_cast<std::size_t>(m_Configuration.decimationFactor);
+    const auto kernel = m_Configuration.kernel == Kernel::Simd ? FirSimd : FirScalar;
+
+    for (std::size_t channel = 0; channel < numberOfChannels; ++channel)
+    {
+        auto& input = m_Input[channel];
+        kernel(input.data(), m_ReversedTaps, decimationFactor, m_Output[channel].data());
+
+        // Keep the tail of this block as the history for the next one.
+        std::copy(input.end() - m_HistorySize, input.end(), input.begin());
+    }
+}
+
+void DecimationFilter::FilterBlockWithCic(const std::size_t numberOfChannels)
+{
+    const auto kernel = m_Configuration.kernel == Kernel::Simd ? CicSimd : CicScalar;
+    const auto numberOfStages = static_cast<std::size_t>(m_Configuration.numberOfStages);
+
+    // One kernel call per vector quantity, the axes of which share a SIMD register.
+    for (std::size_t quantity = 0; quantity < numberOfChannels / NumberOfAxes; ++quantity)
+    {
+        const auto firstChannel = quantity * NumberOfAxes;
+        const auto stateOffset = quantity * numberOfStages * CicLanes;
+        kernel(
+            CicInput{m_Input.data() + firstChannel, NumberOfAxes},
+            m_BlockSize,
+            static_cast<std::size_t>(m_Configuration.decimationFactor),
+            numberOfStages,
+            FixedPointScales[quantity],
+            m_Integrators.data() + stateOffset,
+            m_Combs.data() + stateOffset,
+            CicOutput{m_Output.data() + firstChannel, NumberOfAxes}
+        );
+    }
+}
+
+void DecimationFilter::PublishOutputBlock()
+{
+    for (std::size_t m = 0; m < OutputSamplesPerBlock; ++m)
+    {
+        if (m_NewDataAcquiredObserver)
+        {
+            m_NewDataAcquiredObserver->OnNewDataAcquired(m_Output[0][m], m_Output[1][m], m_Output[2][m]);
+        }
+        if (m_NewMotionDataAcquiredObserver)
+        {
+            m_NewMotionDataAcquiredObserver->OnNewMotionDataAcquired(m_Output[0][m], m_Output[1][m], m_Output[2][m], m_Output[3][m], m_Output[4][m], m_Output[5][m]);
+        }
+    }
+}
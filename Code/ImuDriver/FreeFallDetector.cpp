@@ -14,40 +14,45 @@ constexpr auto NumberOfSamplesToDetectFreeFall = 8;
 
 void FreeFallDetector::SubscribeToFreeFallDetection(FreeFallObserver& observer)
 {
-    if (m_FreeFallObserver)
+    if (m_NumberOfFreeFallObservers == m_FreeFallObservers.size())
     {
-        Log::Error("Current implementation supports only one subscriber");
+        Log::Error(std::format("Current implementation supports up to {} subscribers", m_FreeFallObservers.size()));
         return;
     }
 
-    m_FreeFallObserver = &observer;
+    m_FreeFallObservers[m_NumberOfFreeFallObservers++] = &observer;
+}
+
+void FreeFallDetector::Process(const MotionSample& sample)
+{
+    const auto& [ax, ay, az] = sample.acceleration;
+    Notify(Detect(ax, ay, az));
 }
 
 void FreeFallDetector::OnNewDataAcquired(const float ax, const float ay, const float az)
+{
+    Notify(Detect(ax, ay, az));
+}
+
+FreeFallEvent FreeFallDetector::Detect(const float ax, const float ay, const float az)
 {
     const bool accelerationsAreSmall = AccelerationsAreSmall(ax, ay, az);
     if (not accelerationsAreSmall)
     {
-        if (m_IsFreeFallInProgress and m_FreeFallObserver)
-        {
-            m_FreeFallObserver->OnFreeFallFinished();
-        }
-
+        const auto event = m_IsFreeFallInProgress ? FreeFallEvent::Finished : FreeFallEvent::None;
         m_IsFreeFallInProgress = false;
         m_CurrentFreeFallSamples = 0;
-        return;
+        return event;
     }
 
     m_CurrentFreeFallSamples += accelerationsAreSmall ? 1 : 0;
     if (not m_IsFreeFallInProgress and m_CurrentFreeFallSamples >= NumberOfSamplesToDetectFreeFall)
     {
-        if (m_FreeFallObserver)
-        {
-            m_FreeFallObserver->OnFreeFallStarted();
-        }
-
         m_IsFreeFallInProgress = true;
+        return FreeFallEvent::Started;
     }
+
+    return FreeFallEvent::None;
 }
 
 bool FreeFallDetector::AccelerationsAreSmall(const float ax, const float ay, const float az)
@@ -55,3 +60,23 @@ bool FreeFallDetector::AccelerationsAreSmall(const float ax, const float ay, con
     constexpr auto limit = SmallAccelerationLimit;
     return std::abs(ax) < limit and std::abs(ay) < limit and std::abs(az) < limit;
 }
+
+void FreeFallDetector::Notify(const FreeFallEvent event)
+{
+    if (event == FreeFallEvent::None)
+    {
+        return;
+    }
+
+    for (std::size_t i = 0; i < m_NumberOfFreeFallObservers; ++i)
+    {
+        if (event == FreeFallEvent::Started)
+        {
+            m_FreeFallObservers[i]->OnFreeFallStarted();
+        }
+        else
+        {
+            m_FreeFallObservers[i]->OnFreeFallFinished();
+        }
+    }
+}
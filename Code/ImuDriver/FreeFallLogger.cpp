@@ -1,18 +1,18 @@
 #include "ImuDriver/Implementation/FreeFallLogger.hpp"
 
-#include "ImuDriver/Common/Logger.hpp"
+#include "ImuDriver/Common/BinaryLogger.hpp"
 
+// Logged in binary form, next to the samples, since this runs on the data acquisition thread.
 void FreeFallLogger::OnFreeFallStarted()
 {
-    Log::Info("");
-    Log::Info("Free fall started");
-    Log::Info("");
-
+    Log::Binary::Info<"">();
+    Log::Binary::Info<"Free fall started">();
+    Log::Binary::Info<"">();
 }
 
 void FreeFallLogger::OnFreeFallFinished()
 {
-    Log::Info("");
-    Log::Info("Free fall finished");
-    Log::Info("");
+    Log::Binary::Info<"">();
+    Log::Binary::Info<"Free fall finished">();
+    Log::Binary::Info<"">();
 }
@@ -2,17 +2,40 @@
 
 #include "ImuDriver/Implementation/ImuRegisters.hpp"
 
+#include "ImuDriver/Common/AllocationCounter.hpp"
+#include "ImuDriver/Common/BinaryLogger.hpp"
 #include "ImuDriver/Common/BitOperations.hpp"
 #include "ImuDriver/Common/Logger.hpp"
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <alloca.h>
+
+#include <cerrno>
+#include <cstring>
+#include <future>
 #include <utility>
 
 using namespace Common;
+using Interface::Clock;
 using Interface::I2c;
 
 namespace
 {
 
+constexpr auto PollingPeriod = std::chrono::milliseconds{1};
+
+// ±16 g, selected by the ACCEL_CONFIG0 reset value (0x06), until the accelerometer is configured.
+constexpr auto DefaultAccelerometerScale = ImuDriver::AccelerometerScale::Scale16G;
+// Sensitivity (LSB per unit) for the ±250 dps full scale range, set by ConfigureGyroscope().
+constexpr auto GyroscopeSensitivity = 131.0f;
+
+// Has to stay well below the default thread stack size (8 MiB on Linux).
+constexpr auto MaxPrefaultedStackSize = std::size_t{4 * 1024 * 1024};
+
 constexpr Register::Value AsRegisterValue(const ImuDriver::AccelerometerScale scale)
 {
     using enum ImuDriver::AccelerometerScale;
@@ -39,11 +62,67 @@ constexpr Register::Value AsRegisterValue(const ImuDriver::AccelerometerOutputDa
     std::unreachable();
 }
 
+constexpr Clock::Duration AsPeriod(const ImuDriver::AccelerometerOutputDataRate outputDataRate)
+{
+    using enum ImuDriver::AccelerometerOutputDataRate;
+    switch (outputDataRate)
+    {
+    case Rate50Hz: return std::chrono::milliseconds{20};
+    case Rate25Hz: return std::chrono::milliseconds{40};
+    }
+
+    std::unreachable();
+}
+
+constexpr float AsSensitivity(const ImuDriver::AccelerometerScale scale)
+{
+    using enum ImuDriver::AccelerometerScale;
+    switch (scale)
+    {
+    case Scale16G: return 2048.0f;
+    case Scale8G:  return 4096.0f;
+    case Scale4G:  return 8192.0f;
+    case Scale2G:  return 16384.0f;
+    }
+
+    std::unreachable();
+}
+
+constexpr int AsNativePolicy(const ImuDriver::ThreadConfiguration::SchedulingPolicy policy)
+{
+    using enum ImuDriver::ThreadConfiguration::SchedulingPolicy;
+    switch (policy)
+    {
+    case Default:    return SCHED_OTHER;
+    case Fifo:       return SCHED_FIFO;
+    case RoundRobin: return SCHED_RR;
+    }
+
+    std::unreachable();
+}
+
+// Touches every page of `size` bytes below the current stack frame, so the thread
+// does not take page faults when its stack grows later on.
+[[gnu::noinline]] void PrefaultStack(const std::size_t size)
+{
+    auto* stack = static_cast<volatile std::uint8_t*>(alloca(size));
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    for (std::size_t offset = 0; offset < size; offset += pageSize)
+    {
+        stack[offset] = 0;
+    }
 }
 
-ImuDriver::ImuDriver(I2c& i2c, const I2c::SlaveAddress slaveAddress)
+}
+
+ImuDriver::ImuDriver(I2c& i2c, const I2c::SlaveAddress slaveAddress, Clock& clock)
     : m_I2c{i2c}
     , m_SlaveAddress{slaveAddress}
+    , m_Clock{clock}
+    , m_AccelerometerSensitivity{AsSensitivity(DefaultAccelerometerScale)}
+    , m_OutputDataPeriod{AsPeriod(AccelerometerOutputDataRate::Rate50Hz)}
+    , m_AccelerationConversion{m_AccelerometerSensitivity, m_Calibration.accelerometer}
+    , m_RotationConversion{GyroscopeSensitivity, m_Calibration.gyroscope}
 {
 }
 
@@ -58,6 +137,17 @@ void ImuDriver::SubscribeToNewDataAcquired(NewDataAcquiredObserver& observer)
     m_NewDataAcquiredObserver = &observer;
 }
 
+void ImuDriver::SubscribeToNewMotionDataAcquired(NewMotionDataAcquiredObserver& observer)
+{
+    if (m_NewMotionDataAcquiredObserver)
+    {
+        Log::Error("Current implementation supports only one subscriber");
+        return;
+    }
+
+    m_NewMotionDataAcquiredObserver = &observer;
+}
+
 ImuDriver::Status ImuDriver::Initialize()
 {
     if (auto status = ConfigureAccelerometer(AccelerometerScale::Scale2G, AccelerometerOutputDataRate::Rate50Hz); status != Status::Success)
@@ -65,6 +155,11 @@ ImuDriver::Status ImuDriver::Initialize()
         return status;
     }
 
+    if (auto status = ConfigureGyroscope(); status != Status::Success)
+    {
+        return status;
+    }
+
     return Status::Success;
 }
 
@@ -75,12 +170,28 @@ ImuDriver::Status ImuDriver::Start()
         return status;
     }
 
+    auto threadConfigured = std::promise<ThreadConfigurationResult>{};
+    auto threadConfigurationResult = threadConfigured.get_future();
+
+    // Commands left over from a previous run were already reported as failed.
+    while (m_Commands.TryPop())
+    {
+    }
+
     m_StopSource = std::stop_source{};
+    m_JitterStatistics = JitterStatistics{};
+    m_IsAcquisitionThreadRunning.store(true);
     m_DataAcquisitionThread = std::jthread{
-        [this]{
+        [this, threadConfigured = std::move(threadConfigured)] mutable {
+            m_AcquisitionThreadId.store(std::this_thread::get_id());
+            threadConfigured.set_value(ApplyThreadConfiguration());
             DataAcquisitionThread(m_StopSource.get_token());
+            m_IsAcquisitionThreadRunning.store(false);
+            m_AcquisitionThreadId.store(std::thread::id{});
+            FailPendingCommands();
         }
     };
+    m_ThreadConfigurationResult = threadConfigurationResult.get();
 
     return Status::Success;
 }
@@ -90,6 +201,18 @@ ImuDriver::Status ImuDriver::Stop()
     m_StopSource.request_stop();
     m_DataAcquisitionThread.join();
 
+    if (m_ThreadConfiguration.measureJitter and m_JitterStatistics.numberOfWakeUps > 0)
+    {
+        const auto& jitter = m_JitterStatistics;
+        Log::Info(std::format(
+            "Wake-up latency over {} polls: min={}, mean={}, max={}",
+            jitter.numberOfWakeUps,
+            jitter.minimum,
+            jitter.total / jitter.numberOfWakeUps,
+            jitter.maximum
+        ));
+    }
+
     if (auto status = TurnOffAccelerometerAndGyroscope(); status != Status::Success)
     {
         return status;
@@ -103,40 +226,110 @@ bool ImuDriver::IsDataAcquisitionEnabled() const
     return m_DataAcquisitionThread.joinable();
 }
 
-ImuDriver::Status ImuDriver::ConfigureAccelerometer(const AccelerometerScale scale, const AccelerometerOutputDataRate outputDataRate)
+ImuDriver::Status ImuDriver::SetThreadConfiguration(const ThreadConfiguration& configuration)
 {
-    auto [status, acceleratorConfiguration] = m_I2c.ReadByte(m_SlaveAddress, Register::ACCEL_CONFIG0);
-    if (status != I2c::Status::Success)
+    if (IsDataAcquisitionEnabled())
     {
+        Log::Error("Thread configuration cannot be changed during data acquisition");
         return Status::UnknownError;
     }
 
-    Bits::Clear(acceleratorConfiguration, ACCEL_UI_FS_SEL_MASK | ACCEL_ODR_MASK);
-    Bits::Set(acceleratorConfiguration, AsRegisterValue(scale) | AsRegisterValue(outputDataRate));
+    if (configuration.cpu and (*configuration.cpu < 0 or *configuration.cpu >= CPU_SETSIZE))
+    {
+        Log::Error(std::format("Invalid CPU for data acquisition thread: {}", *configuration.cpu));
+        return Status::UnknownError;
+    }
 
-    if (m_I2c.WriteByte(m_SlaveAddress, Register::ACCEL_CONFIG0, acceleratorConfiguration) != I2c::Status::Success)
+    const auto policy = AsNativePolicy(configuration.schedulingPolicy);
+    if (configuration.schedulingPolicy != ThreadConfiguration::SchedulingPolicy::Default
+        and (configuration.priority < sched_get_priority_min(policy) or configuration.priority > sched_get_priority_max(policy)))
+    {
+        Log::Error(std::format("Invalid priority for data acquisition thread: {}", configuration.priority));
+        return Status::UnknownError;
+    }
+
+    if (configuration.prefaultedStackSize > MaxPrefaultedStackSize)
     {
+        Log::Error(std::format("Stack to prefault too large: {} bytes", configuration.prefaultedStackSize));
         return Status::UnknownError;
     }
 
+    m_ThreadConfiguration = configuration;
     return Status::Success;
 }
 
+ImuDriver::ThreadConfigurationResult ImuDriver::GetThreadConfigurationResult() const
+{
+    return m_ThreadConfigurationResult;
+}
+
+ImuDriver::JitterStatistics ImuDriver::GetJitterStatistics() const
+{
+    return m_JitterStatistics;
+}
+
+ImuDriver::LatestSample ImuDriver::GetLatestSample() const
+{
+    return m_LatestSample.Read();
+}
+
+ImuDriver::Status ImuDriver::ConfigureAccelerometer(const AccelerometerScale scale, const AccelerometerOutputDataRate outputDataRate)
+{
+    // An observer of the acquisition thread runs between two samples already, and waiting
+    // for its own thread to take the command would never end.
+    if (std::this_thread::get_id() == m_AcquisitionThreadId.load())
+    {
+        return ReconfigureAccelerometerBetweenSamples(scale, outputDataRate);
+    }
+
+    if (m_IsAcquisitionThreadRunning.load())
+    {
+        return SendAccelerometerCommand(scale, outputDataRate);
+    }
+
+    return WriteAccelerometerConfiguration(scale, outputDataRate);
+}
+
+ImuDriver::Status ImuDriver::SetCalibration(const ImuCalibration& calibration)
+{
+    if (IsDataAcquisitionEnabled())
+    {
+        Log::Error("Calibration cannot be changed while data acquisition is enabled");
+        return Status::UnknownError;
+    }
+
+    m_Calibration = calibration;
+    m_AccelerationConversion = Conversion{m_AccelerometerSensitivity, m_Calibration.accelerometer};
+    m_RotationConversion = Conversion{GyroscopeSensitivity, m_Calibration.gyroscope};
+    return Status::Success;
+}
+
+const ImuCalibration& ImuDriver::GetCalibration() const
+{
+    return m_Calibration;
+}
+
 void ImuDriver::DataAcquisitionThread(const std::stop_token stopToken)
 {
+    auto lastSampleTime = m_Clock.Now();
     while (!stopToken.stop_requested())
     {
+        const auto allocationsBefore = Allocations::CountInCurrentThread();
+
+        ApplyPendingCommands();
+
         const auto result = m_I2c.ReadByte(m_SlaveAddress, Register::INT_STATUS_DRDY);
         if (result.status != I2c::Status::Success)
         {
             Log::Error("Checking if data is acquired failed");
             return;
         }
+        ++m_NumberOfDataReadyPolls;
 
         const auto isDataReady = Bits::Read(result.readByte, DATA_RDY_INT_MASK) == DATA_RDY_INT_DATA_IS_READY;
         if (not isDataReady)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            SleepUntilNextPoll();
             continue;
         }
 
@@ -147,48 +340,213 @@ void ImuDriver::DataAcquisitionThread(const std::stop_token stopToken)
             return;
         }
 
-        const auto [ax, ay, az] = ConvertToFloat(acquiredData.acceleration);
-        Log::Info(std::format("Received data: ax={: .3f}, ay={: .3f}, az={: .3f}", ax, ay, az));
+        const auto [ax, ay, az] = ConvertAccelerations(acquiredData.acceleration);
+        const auto [gx, gy, gz] = ConvertRotations(acquiredData.rotation);
+
+        // Samples come one output data period apart, so simulated time moves on by that much
+        // even when data was ready without waiting. Real time has passed on its own.
+        m_Clock.AdvanceTo(lastSampleTime + m_OutputDataPeriod);
+        lastSampleTime = m_Clock.Now();
+
+        m_LatestSample.Write({
+            .timestamp = lastSampleTime,
+            .sampleNumber = ++m_NumberOfSamples,
+            .numberOfDataReadyPolls = m_NumberOfDataReadyPolls,
+            .acceleration = {ax, ay, az},
+            .rotation = {gx, gy, gz},
+        });
+        Log::Binary::Info<"Received data: ax={: .3f}, ay={: .3f}, az={: .3f}, gx={: .3f}, gy={: .3f}, gz={: .3f}">(ax, ay, az, gx, gy, gz);
         if (m_NewDataAcquiredObserver)
         {
             m_NewDataAcquiredObserver->OnNewDataAcquired(ax, ay, az);
         }
+        if (m_NewMotionDataAcquiredObserver)
+        {
+            m_NewMotionDataAcquiredObserver->OnNewMotionDataAcquired(ax, ay, az, gx, gy, gz);
+        }
+
+        if constexpr (Allocations::CountingEnabled)
+        {
+            const auto allocations = Allocations::CountInCurrentThread() - allocationsBefore;
+            if (allocations > 0)
+            {
+                Log::Error(std::format("Processing sample {} caused {} heap allocations", m_NumberOfSamples, allocations));
+            }
+        }
     }
 }
 
-std::pair<ImuDriver::Status, ImuDriver::AcquiredData> ImuDriver::ReadAllAcquiredData() const
+// Runs between two samples, so every sample is converted with the range it was measured in.
+void ImuDriver::ApplyPendingCommands()
 {
-    auto result = std::pair<ImuDriver::Status, ImuDriver::AcquiredData>{};
-    auto& [status, readData] = result;
-    status = Status::UnknownError;
+    while (const auto command = m_Commands.TryPop())
+    {
+        Acknowledge(command->id, ReconfigureAccelerometerBetweenSamples(command->scale, command->outputDataRate));
+    }
+}
 
-    auto registerToRead = Register::ACCEL_DATA_X1;
+ImuDriver::Status ImuDriver::ReconfigureAccelerometerBetweenSamples(const AccelerometerScale scale, const AccelerometerOutputDataRate outputDataRate)
+{
+    const auto status = WriteAccelerometerConfiguration(scale, outputDataRate);
+    if (status == Status::Success)
+    {
+        Log::Binary::Info<"Accelerometer reconfigured after sample {}">(m_NumberOfSamples);
+    }
+    return status;
+}
 
+void ImuDriver::FailPendingCommands()
+{
+    while (const auto command = m_Commands.TryPop())
     {
-        const auto [status, singleData] = ReadSingleAcquiredData(registerToRead);
-        if (status != Status::Success)
+        Acknowledge(command->id, Status::UnknownError);
+    }
+}
+
+void ImuDriver::Acknowledge(const std::uint64_t commandId, const Status status)
+{
+    m_CommandAcknowledgement.store(commandId << 1 | (status == Status::Success ? 0 : 1), std::memory_order_release);
+    m_CommandAcknowledgement.notify_all();
+}
+
+ImuDriver::Status ImuDriver::SendAccelerometerCommand(const AccelerometerScale scale, const AccelerometerOutputDataRate outputDataRate)
+{
+    const auto lock = std::lock_guard{m_CommandMutex};
+    const auto id = ++m_LastCommandId;
+    if (not m_Commands.TryPush({id, scale, outputDataRate}))
+    {
+        Log::Error("Accelerometer command queue is full");
+        return Status::UnknownError;
+    }
+
+    const auto toStatus = [](const std::uint64_t acknowledgement) { return (acknowledgement & 1) == 0 ? Status::Success : Status::UnknownError; };
+    while (true)
+    {
+        const auto acknowledgement = m_CommandAcknowledgement.load(std::memory_order_acquire);
+        if (acknowledgement >> 1 == id)
         {
-            return result;
+            return toStatus(acknowledgement);
         }
-        readData.acceleration[0] = singleData;
+
+        // The thread fails the commands it finds queued after it stopped running, but it
+        // may have stopped before this command was queued.
+        if (not m_IsAcquisitionThreadRunning.load())
+        {
+            if (const auto last = m_CommandAcknowledgement.load(std::memory_order_acquire); last >> 1 == id)
+            {
+                return toStatus(last);
+            }
+            Log::Error("Data acquisition stopped before the accelerometer configuration was applied");
+            return Status::UnknownError;
+        }
+
+        m_CommandAcknowledgement.wait(acknowledgement, std::memory_order_acquire);
     }
+}
 
+ImuDriver::Status ImuDriver::WriteAccelerometerConfiguration(const AccelerometerScale scale, const AccelerometerOutputDataRate outputDataRate)
+{
+    auto [status, acceleratorConfiguration] = m_I2c.ReadByte(m_SlaveAddress, Register::ACCEL_CONFIG0);
+    if (status != I2c::Status::Success)
     {
-        const auto [status, singleData] = ReadSingleAcquiredData(registerToRead);
-        if (status != Status::Success)
+        return Status::UnknownError;
+    }
+
+    Bits::Clear(acceleratorConfiguration, ACCEL_UI_FS_SEL_MASK | ACCEL_ODR_MASK);
+    Bits::Set(acceleratorConfiguration, AsRegisterValue(scale) | AsRegisterValue(outputDataRate));
+
+    if (m_I2c.WriteByte(m_SlaveAddress, Register::ACCEL_CONFIG0, acceleratorConfiguration) != I2c::Status::Success)
+    {
+        return Status::UnknownError;
+    }
+
+    m_AccelerometerSensitivity = AsSensitivity(scale);
+    m_OutputDataPeriod = AsPeriod(outputDataRate);
+    m_AccelerationConversion = Conversion{m_AccelerometerSensitivity, m_Calibration.accelerometer};
+    return Status::Success;
+}
+
+ImuDriver::ThreadConfigurationResult ImuDriver::ApplyThreadConfiguration() const
+{
+    auto result = ThreadConfigurationResult{};
+    const auto& configuration = m_ThreadConfiguration;
+
+    if (configuration.cpu)
+    {
+        auto cpus = cpu_set_t{};
+        CPU_ZERO(&cpus);
+        CPU_SET(*configuration.cpu, &cpus);
+        if (const auto error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus); error != 0)
         {
-            return result;
+            Log::Error(std::format("Setting CPU affinity of data acquisition thread failed: {}", std::strerror(error)));
+            result.affinityGranted = false;
         }
-        readData.acceleration[1] = singleData;
     }
 
+    if (configuration.schedulingPolicy != ThreadConfiguration::SchedulingPolicy::Default)
     {
-        const auto [status, singleData] = ReadSingleAcquiredData(registerToRead);
-        if (status != Status::Success)
+        auto parameters = sched_param{};
+        parameters.sched_priority = configuration.priority;
+        if (const auto error = pthread_setschedparam(pthread_self(), AsNativePolicy(configuration.schedulingPolicy), &parameters); error != 0)
         {
-            return result;
+            Log::Error(std::format("Setting scheduling of data acquisition thread failed: {}", std::strerror(error)));
+            result.schedulingGranted = false;
+        }
+    }
+
+    if (configuration.lockMemory and mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        Log::Error(std::format("Locking memory failed: {}", std::strerror(errno)));
+        result.memoryLocked = false;
+    }
+
+    if (configuration.prefaultedStackSize > 0)
+    {
+        PrefaultStack(configuration.prefaultedStackSize);
+    }
+
+    return result;
+}
+
+void ImuDriver::SleepUntilNextPoll()
+{
+    if (not m_ThreadConfiguration.measureJitter)
+    {
+        m_Clock.SleepFor(PollingPeriod);
+        return;
+    }
+
+    const auto sleepStart = m_Clock.Now();
+    m_Clock.SleepFor(PollingPeriod);
+    const auto latency = m_Clock.Now() - sleepStart - PollingPeriod;
+
+    auto& jitter = m_JitterStatistics;
+    ++jitter.numberOfWakeUps;
+    jitter.minimum = std::min(jitter.minimum, latency);
+    jitter.maximum = std::max(jitter.maximum, latency);
+    jitter.total += latency;
+}
+
+std::pair<ImuDriver::Status, ImuDriver::AcquiredData> ImuDriver::ReadAllAcquiredData() const
+{
+    auto result = std::pair<ImuDriver::Status, ImuDriver::AcquiredData>{};
+    auto& [status, readData] = result;
+    status = Status::UnknownError;
+
+    // Gyroscope data registers directly follow the accelerometer ones.
+    auto registerToRead = Register::ACCEL_DATA_X1;
+
+    for (auto* acquired : {&readData.acceleration, &readData.rotation})
+    {
+        for (auto& axis : *acquired)
+        {
+            const auto [status, singleData] = ReadSingleAcquiredData(registerToRead);
+            if (status != Status::Success)
+            {
+                return result;
+            }
+            axis = singleData;
         }
-        readData.acceleration[2] = singleData;
     }
 
     status = Status::Success;
@@ -223,20 +581,42 @@ std::pair<ImuDriver::Status, std::uint16_t> ImuDriver::ReadSingleAcquiredData(Re
     return result;
 }
 
-std::array<float, 3> ImuDriver::ConvertToFloat(const AcquiredData::Accelerations& acquired) const
+std::array<float, 3> ImuDriver::ConvertAccelerations(const AcquiredData::Accelerations& acquired) const
 {
     return {
-        ConvertToFloat(acquired[0]),
-        ConvertToFloat(acquired[1]),
-        ConvertToFloat(acquired[2])
+        m_AccelerationConversion.Apply(0, static_cast<std::int16_t>(acquired[0])),
+        m_AccelerationConversion.Apply(1, static_cast<std::int16_t>(acquired[1])),
+        m_AccelerationConversion.Apply(2, static_cast<std::int16_t>(acquired[2]))
     };
 }
 
-float ImuDriver::ConvertToFloat(const std::uint16_t acquired) const
+std::array<float, 3> ImuDriver::ConvertRotations(const AcquiredData::Rotations& acquired) const
 {
-    return static_cast<float>(
-        static_cast<std::int16_t>(acquired)
-    ) / 16384;
+    return {
+        m_RotationConversion.Apply(0, static_cast<std::int16_t>(acquired[0])),
+        m_RotationConversion.Apply(1, static_cast<std::int16_t>(acquired[1])),
+        m_RotationConversion.Apply(2, static_cast<std::int16_t>(acquired[2]))
+    };
+}
+
+// Range and rate are fixed for now, to match GyroscopeSensitivity and the default accelerometer ODR.
+ImuDriver::Status ImuDriver::ConfigureGyroscope()
+{
+    auto [status, gyroscopeConfiguration] = m_I2c.ReadByte(m_SlaveAddress, Register::GYRO_CONFIG0);
+    if (status != I2c::Status::Success)
+    {
+        return Status::UnknownError;
+    }
+
+    Bits::Clear(gyroscopeConfiguration, GYRO_UI_FS_SEL_MASK | GYRO_ODR_MASK);
+    Bits::Set(gyroscopeConfiguration, GYRO_UI_FS_SEL_250DPS | GYRO_ODR_50HZ);
+
+    if (m_I2c.WriteByte(m_SlaveAddress, Register::GYRO_CONFIG0, gyroscopeConfiguration) != I2c::Status::Success)
+    {
+        return Status::UnknownError;
+    }
+
+    return Status::Success;
 }
 
 ImuDriver::Status ImuDriver::TurnOnAccelerometerAndGyroscopeInLowNoiseMode()
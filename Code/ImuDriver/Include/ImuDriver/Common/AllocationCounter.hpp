@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Diagnostics for the allocation-free acquisition path. When the driver is built with
+// IMU_DRIVER_COUNT_ALLOCATIONS, the global allocator is replaced with one that counts
+// allocations per thread, and every sample which touches the heap is reported.
+namespace Common::Allocations
+{
+
+#if defined(IMU_DRIVER_COUNT_ALLOCATIONS)
+
+constexpr auto CountingEnabled = true;
+
+// Number of heap allocations made so far by the calling thread.
+std::uint64_t CountInCurrentThread();
+
+#else
+
+constexpr auto CountingEnabled = false;
+
+inline std::uint64_t CountInCurrentThread()
+{
+    return 0;
+}
+
+#endif
+
+}
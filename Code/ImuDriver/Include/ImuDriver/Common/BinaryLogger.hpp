@@ -0,0 +1,189 @@
+#pragma once
+
+#include "ImuDriver/Common/Logger.hpp"
+
+#include "ImuDriver/Interface/Clock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+// Logging for hot paths. Instead of formatting at the call site, each call stores only
+// the ID of its (compile-time) format string and the raw bytes of its arguments.
+// Records are written to FileName by a background thread and turned into text by
+// the ImuLogDecoder tool. Only arithmetic arguments are supported. The thread is started
+// by Configure() or the first record, and the file is only opened once there is a record
+// to write, so binaries which never log leave no file behind.
+//
+// Usage: Log::Binary::Info<"Received data: ax={: .3f}">(ax);
+namespace Log::Binary
+{
+
+constexpr auto FileName = "logs.bin";
+
+// Every logging session starts with this header; the decoder resets its format table on it.
+// It is followed by the wall clock time and the logging clock time at the start of the
+// session (std::int64_t nanoseconds each), which map record timestamps to wall clock time.
+constexpr auto FileMagic = std::array<char, 8>{'I', 'M', 'U', 'L', 'O', 'G', '0', '2'};
+
+enum class Level : std::uint8_t
+{
+    Debug,
+    Info,
+    Error,
+};
+
+enum class RecordKind : std::uint8_t
+{
+    FormatDefinition,
+    Message,
+};
+
+enum class ArgumentType : std::uint8_t
+{
+    Bool,
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float,
+    Double,
+};
+
+enum class OverflowPolicy : std::uint8_t
+{
+    // The record is dropped (and the drop counted), logging never waits.
+    Drop,
+    // The logging thread waits for the writer to free a slot. For virtual time, where
+    // acquisition runs at CPU speed and would otherwise outrun the writer.
+    Wait,
+};
+
+using FormatId = std::uint16_t;
+
+constexpr std::size_t MaxArgumentsSize = 48;
+
+template<std::size_t Size>
+struct FormatString
+{
+    constexpr FormatString(const char (&text)[Size])
+    {
+        std::copy_n(text, Size, m_Text);
+    }
+
+    constexpr std::string_view View() const
+    {
+        return {m_Text, Size - 1};
+    }
+
+    char m_Text[Size];
+};
+
+// Records are timestamped with `clock`, so that logs of simulated runs show simulated
+// time. Until configured, they are timestamped with std::chrono::steady_clock and dropped
+// when the queue is full. The clock has to outlive all logging.
+void Configure(Interface::Clock& clock, OverflowPolicy overflowPolicy);
+
+namespace Detail
+{
+
+template<typename T>
+constexpr ArgumentType TypeOf()
+{
+    static_assert(std::is_arithmetic_v<T>, "Binary logs support only arithmetic arguments");
+
+    if constexpr (std::is_same_v<T, bool>) return ArgumentType::Bool;
+    else if constexpr (std::is_same_v<T, float>) return ArgumentType::Float;
+    else if constexpr (std::is_floating_point_v<T>) return ArgumentType::Double;
+    else if constexpr (std::is_signed_v<T>) return sizeof(T) <= 4 ? ArgumentType::Int32 : ArgumentType::Int64;
+    else return sizeof(T) <= 4 ? ArgumentType::UInt32 : ArgumentType::UInt64;
+}
+
+template<ArgumentType Type>
+using Stored =
+    std::conditional_t<Type == ArgumentType::Bool, bool,
+    std::conditional_t<Type == ArgumentType::Int32, std::int32_t,
+    std::conditional_t<Type == ArgumentType::UInt32, std::uint32_t,
+    std::conditional_t<Type == ArgumentType::Int64, std::int64_t,
+    std::conditional_t<Type == ArgumentType::UInt64, std::uint64_t,
+    std::conditional_t<Type == ArgumentType::Float, float, double>>>>>>;
+
+constexpr std::size_t SizeOf(const ArgumentType type)
+{
+    switch (type)
+    {
+    case ArgumentType::Bool:   return sizeof(Stored<ArgumentType::Bool>);
+    case ArgumentType::Int32:  return sizeof(Stored<ArgumentType::Int32>);
+    case ArgumentType::UInt32: return sizeof(Stored<ArgumentType::UInt32>);
+    case ArgumentType::Int64:  return sizeof(Stored<ArgumentType::Int64>);
+    case ArgumentType::UInt64: return sizeof(Stored<ArgumentType::UInt64>);
+    case ArgumentType::Float:  return sizeof(Stored<ArgumentType::Float>);
+    case ArgumentType::Double: return sizeof(Stored<ArgumentType::Double>);
+    }
+
+    return 0;
+}
+
+// Called once per format; assigns the ID under which the format is stored in the log.
+FormatId RegisterFormat(Level level, std::string_view format, std::span<const ArgumentType> arguments);
+
+// Initialised during static initialisation, before main, so the first record of a format
+// does not allocate on the thread which writes it. Registering does not start the writer.
+template<Level MessageLevel, FormatString Format, ArgumentType... Types>
+inline const FormatId RegisteredFormat = RegisterFormat(MessageLevel, Format.View(), std::array<ArgumentType, sizeof...(Types)>{Types...});
+
+// Wait-free unless the queue is full and OverflowPolicy::Wait is configured.
+void Write(FormatId id, const std::byte* arguments, std::size_t size);
+
+template<typename T>
+std::size_t Append(std::byte* target, const T& argument)
+{
+    const auto stored = static_cast<Stored<TypeOf<T>()>>(argument);
+    std::memcpy(target, &stored, sizeof(stored));
+    return sizeof(stored);
+}
+
+template<Level MessageLevel, FormatString Format, typename... Args>
+void Record(const Args&... args)
+{
+    static_assert((SizeOf(TypeOf<Args>()) + ... + 0) <= MaxArgumentsSize, "Too many arguments for a binary log record");
+    [[maybe_unused]] constexpr auto validatedFormat = std::format_string<const Args&...>{Format.View()};
+
+    const auto id = RegisteredFormat<MessageLevel, Format, TypeOf<Args>()...>;
+
+    auto arguments = std::array<std::byte, MaxArgumentsSize>{};
+    auto size = std::size_t{0};
+    ((size += Append(arguments.data() + size, args)), ...);
+
+    Write(id, arguments.data(), size);
+}
+
+}
+
+template<FormatString Format, typename... Args>
+void Debug(const Args&... args)
+{
+    if constexpr (DebugLogsEnabled)
+    {
+        Detail::Record<Level::Debug, Format>(args...);
+    }
+}
+
+template<FormatString Format, typename... Args>
+void Info(const Args&... args)
+{
+    Detail::Record<Level::Info, Format>(args...);
+}
+
+template<FormatString Format, typename... Args>
+void Error(const Args&... args)
+{
+    Detail::Record<Level::Error, Format>(args...);
+}
+
+}
@@ -13,5 +13,6 @@ void Info(const Message& message);
 void Error(const Message& message);
 
 constexpr auto FileName = "logs.txt";
+constexpr auto DebugLogsEnabled = false;
 
 }
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Common
+{
+
+// Publishes a value from a single writer to any number of readers. Writing never
+// waits; a read which overlaps a write is retried, so readers never block the writer.
+template<typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T> and std::is_default_constructible_v<T>);
+
+public:
+    void Write(const T& value)
+    {
+        const auto sequence = m_Sequence.load(std::memory_order_relaxed);
+        m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto words = std::array<std::uint64_t, NumberOfWords>{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (std::size_t i = 0; i < NumberOfWords; ++i)
+        {
+            m_Words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_Sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    T Read() const
+    {
+        auto words = std::array<std::uint64_t, NumberOfWords>{};
+        while (true)
+        {
+            const auto before = m_Sequence.load(std::memory_order_acquire);
+            if (before % 2 != 0)
+            {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < NumberOfWords; ++i)
+            {
+                words[i] = m_Words[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_Sequence.load(std::memory_order_relaxed) == before)
+            {
+                break;
+            }
+        }
+
+        // T is trivially copyable, but may still have a non-trivial default constructor
+        // (std::chrono::time_point has one), which -Wclass-memaccess would complain about.
+        auto value = T{};
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr auto NumberOfWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    // Words are stored through atomics, so a torn read is detected rather than being a data race.
+    alignas(64) std::atomic<std::uint64_t> m_Sequence = 0;
+    std::array<std::atomic<std::uint64_t>, NumberOfWords> m_Words{};
+};
+
+}
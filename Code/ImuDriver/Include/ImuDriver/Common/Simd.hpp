@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__AVX2__) and defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#else
+#include <cmath>
+#endif
+
+// Thin wrapper over the widest float vector available in the current build,
+// so kernels can be written once and compiled for AVX2, SSE or plain scalar code.
+namespace Common::Simd
+{
+
+#if defined(__AVX2__) and defined(__FMA__)
+
+struct Floats
+{
+    __m256 value;
+};
+
+constexpr std::size_t Width = 8;
+
+inline Floats Load(const float* source) { return {_mm256_loadu_ps(source)}; }
+inline void Store(float* target, const Floats floats) { _mm256_storeu_ps(target, floats.value); }
+inline Floats Broadcast(const float value) { return {_mm256_set1_ps(value)}; }
+inline Floats Zero() { return {_mm256_setzero_ps()}; }
+
+inline Floats operator+(const Floats lhs, const Floats rhs) { return {_mm256_add_ps(lhs.value, rhs.value)}; }
+inline Floats operator-(const Floats lhs, const Floats rhs) { return {_mm256_sub_ps(lhs.value, rhs.value)}; }
+inline Floats operator*(const Floats lhs, const Floats rhs) { return {_mm256_mul_ps(lhs.value, rhs.value)}; }
+inline Floats operator/(const Floats lhs, const Floats rhs) { return {_mm256_div_ps(lhs.value, rhs.value)}; }
+
+// Returns a * b + c.
+inline Floats MultiplyAdd(const Floats a, const Floats b, const Floats c) { return {_mm256_fmadd_ps(a.value, b.value, c.value)}; }
+inline Floats Sqrt(const Floats floats) { return {_mm256_sqrt_ps(floats.value)}; }
+inline Floats Max(const Floats lhs, const Floats rhs) { return {_mm256_max_ps(lhs.value, rhs.value)}; }
+inline Floats Min(const Floats lhs, const Floats rhs) { return {_mm256_min_ps(lhs.value, rhs.value)}; }
+
+// Returns 1 in lanes where lhs > rhs and 0 elsewhere, to be used as a multiplier.
+inline Floats Greater(const Floats lhs, const Floats rhs) { return {_mm256_and_ps(_mm256_cmp_ps(lhs.value, rhs.value, _CMP_GT_OQ), _mm256_set1_ps(1.0f))}; }
+
+inline float HorizontalSum(const Floats floats)
+{
+    const auto halves = _mm_add_ps(_mm256_castps256_ps128(floats.value), _mm256_extractf128_ps(floats.value, 1));
+    const auto pairs = _mm_add_ps(halves, _mm_movehl_ps(halves, halves));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+}
+
+#elif defined(__SSE2__)
+
+struct Floats
+{
+    __m128 value;
+};
+
+constexpr std::size_t Width = 4;
+
+inline Floats Load(const float* source) { return {_mm_loadu_ps(source)}; }
+inline void Store(float* target, const Floats floats) { _mm_storeu_ps(target, floats.value); }
+inline Floats Broadcast(const float value) { return {_mm_set1_ps(value)}; }
+inline Floats Zero() { return {_mm_setzero_ps()}; }
+
+inline Floats operator+(const Floats lhs, const Floats rhs) { return {_mm_add_ps(lhs.value, rhs.value)}; }
+inline Floats operator-(const Floats lhs, const Floats rhs) { return {_mm_sub_ps(lhs.value, rhs.value)}; }
+inline Floats operator*(const Floats lhs, const Floats rhs) { return {_mm_mul_ps(lhs.value, rhs.value)}; }
+inline Floats operator/(const Floats lhs, const Floats rhs) { return {_mm_div_ps(lhs.value, rhs.value)}; }
+
+// Returns a * b + c (SSE has no fused instruction, so this rounds twice).
+inline Floats MultiplyAdd(const Floats a, const Floats b, const Floats c) { return {_mm_add_ps(_mm_mul_ps(a.value, b.value), c.value)}; }
+inline Floats Sqrt(const Floats floats) { return {_mm_sqrt_ps(floats.value)}; }
+inline Floats Max(const Floats lhs, const Floats rhs) { return {_mm_max_ps(lhs.value, rhs.value)}; }
+inline Floats Min(const Floats lhs, const Floats rhs) { return {_mm_min_ps(lhs.value, rhs.value)}; }
+
+// Returns 1 in lanes where lhs > rhs and 0 elsewhere, to be used as a multiplier.
+inline Floats Greater(const Floats lhs, const Floats rhs) { return {_mm_and_ps(_mm_cmpgt_ps(lhs.value, rhs.value), _mm_set1_ps(1.0f))}; }
+
+inline float HorizontalSum(const Floats floats)
+{
+    const auto pairs = _mm_add_ps(floats.value, _mm_movehl_ps(floats.value, floats.value));
+    return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 0x55)));
+}
+
+#else
+
+struct Floats
+{
+    float value;
+};
+
+constexpr std::size_t Width = 1;
+
+inline Floats Load(const float* source) { return {*source}; }
+inline void Store(float* target, const Floats floats) { *target = floats.value; }
+inline Floats Broadcast(const float value) { return {value}; }
+inline Floats Zero() { return {0.0f}; }
+
+inline Floats operator+(const Floats lhs, const Floats rhs) { return {lhs.value + rhs.value}; }
+inline Floats operator-(const Floats lhs, const Floats rhs) { return {lhs.value - rhs.value}; }
+inline Floats operator*(const Floats lhs, const Floats rhs) { return {lhs.value * rhs.value}; }
+inline Floats operator/(const Floats lhs, const Floats rhs) { return {lhs.value / rhs.value}; }
+
+inline Floats MultiplyAdd(const Floats a, const Floats b, const Floats c) { return {std::fma(a.value, b.value, c.value)}; }
+inline Floats Sqrt(const Floats floats) { return {std::sqrt(floats.value)}; }
+inline Floats Max(const Floats lhs, const Floats rhs) { return {lhs.value > rhs.value ? lhs.value : rhs.value}; }
+inline Floats Min(const Floats lhs, const Floats rhs) { return {lhs.value < rhs.value ? lhs.value : rhs.value}; }
+inline Floats Greater(const Floats lhs, const Floats rhs) { return {lhs.value > rhs.value ? 1.0f : 0.0f}; }
+
+inline float HorizontalSum(const Floats floats) { return floats.value; }
+
+#endif
+
+// Number of floats needed to hold `count` values padded up to a whole number of vectors.
+constexpr std::size_t PaddedSize(const std::size_t count)
+{
+    return (count + Width - 1) / Width * Width;
+}
+
+}
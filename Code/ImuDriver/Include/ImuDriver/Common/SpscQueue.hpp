@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+namespace Common
+{
+
+// Bounded queue between exactly one producer thread and one consumer thread. Neither
+// side ever waits for the other: pushing into a full queue and popping from an empty
+// one fail immediately.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert(std::is_trivially_copyable_v<T> and std::is_default_constructible_v<T>);
+    static_assert(Capacity > 0 and (Capacity & (Capacity - 1)) == 0, "Queue capacity has to be a power of two");
+
+public:
+    // Producer side.
+    bool TryPush(const T& value)
+    {
+        const auto tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_Head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        m_Items[tail % Capacity] = value;
+        m_Tail.store(tail + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Consumer side.
+    std::optional<T> TryPop()
+    {
+        const auto head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_Tail.load(std::memory_order_seq_cst))
+        {
+            return std::nullopt;
+        }
+
+        const auto value = m_Items[head % Capacity];
+        m_Head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+private:
+    std::array<T, Capacity> m_Items{};
+    // Positions only grow, the indices into m_Items are taken modulo capacity.
+    alignas(64) std::atomic<std::size_t> m_Head = 0;
+    alignas(64) std::atomic<std::size_t> m_Tail = 0;
+};
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ImuDriver/Implementation/FreeFallDetector.hpp"
+
+#include "ImuDriver/Interface/Clock.hpp"
+#include "ImuDriver/Interface/ImuDriver.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Keeps the most recent samples in a fixed-size ring buffer and, when a free fall starts,
+// dumps the samples around it (pre-trigger and post-trigger windows) to a binary file.
+// Recording runs on the data acquisition thread and never allocates; files are written
+// by a background thread. A free fall detected while the previous dump is still being
+// written is not recorded. Dumps are numbered after those already in the working
+// directory, so a new run never overwrites the dumps of an earlier one.
+//
+// File layout (native byte order):
+//   FileMagic, std::uint32_t numberOfSamples, std::uint32_t triggerIndex,
+//   numberOfSamples x {std::int64_t timestamp [ns], float ax, ay, az [g], float gx, gy, gz [dps]}
+// where triggerIndex is the index of the first sample acquired after free fall detection.
+class BlackBoxRecorder
+    : public Interface::ImuDriver::NewMotionDataAcquiredObserver
+    , public FreeFallDetector::FreeFallObserver
+{
+public:
+    struct Configuration
+    {
+        std::size_t preTriggerSamples;
+        std::size_t postTriggerSamples;
+    };
+
+    BlackBoxRecorder(Interface::Clock& clock, Configuration configuration);
+    ~BlackBoxRecorder() override;
+
+    // Pipeline stage: records the sample. Dumps are still triggered through FreeFallObserver.
+    void Process(const MotionSample& sample);
+
+    static constexpr auto FileMagic = std::to_array({'I', 'M', 'U', 'B', 'B', 'X', '0', '1'});
+    static constexpr auto FileNamePrefix = std::string_view{"blackbox_"};
+
+private:
+    void OnNewMotionDataAcquired(float ax, float ay, float az, float gx, float gy, float gz) override;
+    void OnFreeFallStarted() override;
+    void OnFreeFallFinished() override;
+
+    struct Sample
+    {
+        std::int64_t timestamp;
+        std::array<float, 3> acceleration;
+        std::array<float, 3> rotation;
+    };
+
+    enum class DumpState
+    {
+        Idle,
+        Pending,
+        Stopping,
+    };
+
+    void Record(const MotionSample& sample);
+    void Trigger();
+    void HandOverDump();
+    void WriterThread();
+    void WriteDump(const std::string& fileName) const;
+
+    Interface::Clock& m_Clock;
+    const Configuration m_Configuration;
+
+    // Owned by the data acquisition thread.
+    std::vector<Sample> m_Ring;
+    std::size_t m_NextSample = 0;
+    std::size_t m_NumberOfStoredSamples = 0;
+    std::size_t m_PreTriggerSamples = 0;
+    std::size_t m_RemainingPostTriggerSamples = 0;
+    bool m_IsCapturing = false;
+
+    // Owned by the data acquisition thread while Idle, by the writer thread while Pending.
+    std::vector<Sample> m_Dump;
+    std::size_t m_DumpSize = 0;
+    std::size_t m_DumpTriggerIndex = 0;
+
+    std::atomic<DumpState> m_DumpState = DumpState::Idle;
+    std::jthread m_WriterThread;
+};
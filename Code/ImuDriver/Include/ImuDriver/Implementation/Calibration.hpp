@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+// Per-axis correction of a sensor: calibrated = gain * (measured - offset).
+struct Calibration
+{
+    std::array<float, 3> offset = {0.0f, 0.0f, 0.0f};
+    std::array<float, 3> gain = {1.0f, 1.0f, 1.0f};
+};
+
+struct ImuCalibration
+{
+    enum class Status
+    {
+        Success,
+        FileError,
+    };
+
+    Calibration accelerometer;
+    Calibration gyroscope;
+
+    Status Save(const std::string& path) const;
+    static std::pair<Status, ImuCalibration> Load(const std::string& path);
+
+    static constexpr auto FileName = "calibration.txt";
+};
+
+// Turns raw register values into calibrated physical values, with sensitivity, gain and
+// offset precomputed into a single multiply-add per axis: value = raw * scale + offset.
+class Conversion
+{
+public:
+    Conversion(float sensitivity, const Calibration& calibration);
+
+    float Apply(std::size_t axis, std::int16_t raw) const;
+
+private:
+    std::array<float, 3> m_Scale;
+    std::array<float, 3> m_Offset;
+};
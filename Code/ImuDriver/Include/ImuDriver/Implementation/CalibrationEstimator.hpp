@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ImuDriver/Implementation/Calibration.hpp"
+#include "ImuDriver/Implementation/MotionSample.hpp"
+
+#include "ImuDriver/Interface/ImuDriver.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Estimates calibration incrementally from samples taken while the IMU is at rest.
+// A single stationary capture yields gyroscope biases and accelerometer offsets of the
+// axes perpendicular to gravity. Holding the IMU still in several poses, with each axis
+// pointing up and down in turn (six-position capture), also yields accelerometer gains.
+// The estimate is meant to be read once data acquisition is stopped, and it is only
+// meaningful for samples converted without calibration (the default ImuCalibration).
+//
+// Without the up and down poses of an axis, its offset is taken from the poses in which
+// it is horizontal, so any residual tilt of those poses counts as bias (about 0.017 g per
+// degree). Only the six-position capture separates bias from tilt.
+class CalibrationEstimator
+    : public Interface::ImuDriver::NewMotionDataAcquiredObserver
+{
+public:
+    // Samples are only taken into account between these calls. Both have to be called while
+    // data acquisition is stopped; BeginCapture() discards the previous estimate.
+    void BeginCapture();
+    void EndCapture();
+    bool IsCapturing() const;
+
+    // Pipeline stage.
+    void Process(const MotionSample& sample);
+
+    ImuCalibration GetEstimate() const;
+    std::uint64_t GetNumberOfStationarySamples() const;
+
+private:
+    void OnNewMotionDataAcquired(float ax, float ay, float az, float gx, float gy, float gz) override;
+
+    class RunningMean
+    {
+    public:
+        void Add(double value);
+        bool IsReliable() const;
+        double Get() const;
+
+    private:
+        double m_Mean = 0.0;
+        std::uint64_t m_Count = 0;
+    };
+
+    // Accelerometer readings of one axis: pointing up, pointing down and horizontal.
+    struct AxisPoses
+    {
+        RunningMean up;
+        RunningMean down;
+        RunningMean horizontal;
+    };
+
+    std::array<AxisPoses, 3> m_Accelerometer;
+    std::array<RunningMean, 3> m_Gyroscope;
+    std::uint64_t m_NumberOfStationarySamples = 0;
+    bool m_IsCapturing = false;
+};
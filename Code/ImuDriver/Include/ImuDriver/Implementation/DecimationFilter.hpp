@@ -0,0 +1,104 @@
+#pragma once
+
+#include "ImuDriver/Implementation/MotionSample.hpp"
+
+#include "ImuDriver/Interface/ImuDriver.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Low-pass filters and decimates the data of an upstream IMU, so observers subscribed to
+// this filter receive band-limited data at a fraction of the ODR. It takes accelerations
+// from NewDataAcquired, or accelerations and angular rates from NewMotionDataAcquired or
+// as a Pipeline stage. Angular rates are only filtered while a NewMotionDataAcquired
+// observer is subscribed.
+//
+// Samples are gathered into blocks (one vector per channel) and filtered block by block,
+// so output comes in bursts: 8 samples at once after every 8 * decimationFactor inputs.
+// The first sample of a burst waits 7 * decimationFactor input periods for the rest of
+// its block, on top of the group delay of the filter.
+class DecimationFilter
+    : public Interface::ImuDriver
+    , public Interface::ImuDriver::NewDataAcquiredObserver
+    , public Interface::ImuDriver::NewMotionDataAcquiredObserver
+{
+public:
+    using NewDataAcquiredObserver = Interface::ImuDriver::NewDataAcquiredObserver;
+    using NewMotionDataAcquiredObserver = Interface::ImuDriver::NewMotionDataAcquiredObserver;
+
+    enum class Status
+    {
+        Success,
+        InvalidConfiguration,
+    };
+
+    enum class Type
+    {
+        // Windowed-sinc low-pass; with decimation factor 2 it is a half-band filter.
+        FiniteImpulseResponse,
+        // Multiplierless integrator-comb cascade, suited for large decimation factors.
+        CascadedIntegratorComb,
+    };
+
+    enum class Kernel
+    {
+        // Reference implementation, one sample and one axis at a time.
+        Scalar,
+        // SSE/AVX2 implementation, depending on the instruction set the driver was built for.
+        Simd,
+    };
+
+    struct Configuration
+    {
+        Type type = Type::FiniteImpulseResponse;
+        Kernel kernel = Kernel::Simd;
+        int decimationFactor = 2;
+        int numberOfTaps = 31;
+        int numberOfStages = 3;
+    };
+
+    DecimationFilter();
+
+    // Must not be called while the upstream IMU delivers data.
+    Status Configure(const Configuration& configuration);
+
+    void SubscribeToNewDataAcquired(NewDataAcquiredObserver& observer) override;
+    void SubscribeToNewMotionDataAcquired(NewMotionDataAcquiredObserver& observer);
+
+    // Pipeline stage. The sample itself is left unchanged for the stages after this one.
+    void Process(const MotionSample& sample);
+
+private:
+    // Accelerations x, y, z, then angular rates x, y, z.
+    static constexpr std::size_t NumberOfChannels = 6;
+
+    void OnNewDataAcquired(float ax, float ay, float az) override;
+    void OnNewMotionDataAcquired(float ax, float ay, float az, float gx, float gy, float gz) override;
+
+    void FilterBlockWithFir(std::size_t numberOfChannels);
+    void FilterBlockWithCic(std::size_t numberOfChannels);
+    void PublishOutputBlock();
+
+    Configuration m_Configuration;
+    NewDataAcquiredObserver* m_NewDataAcquiredObserver = nullptr;
+    NewMotionDataAcquiredObserver* m_NewMotionDataAcquiredObserver = nullptr;
+
+    // Input samples in structure-of-arrays layout. For FIR each channel is prefixed
+    // with the history needed by the taps, followed by the current block.
+    std::array<std::vector<float>, NumberOfChannels> m_Input;
+    std::size_t m_HistorySize = 0;
+    std::size_t m_BlockSize = 0;
+    std::size_t m_SamplesInBlock = 0;
+
+    // Taps in reverse order, front-padded with zeros to a whole number of SIMD vectors.
+    std::vector<float> m_ReversedTaps;
+
+    // CIC state: integrators and combs per stage, with axes interleaved as x, y, z, padding.
+    // The state of the angular rates follows the state of the accelerations.
+    std::vector<std::uint32_t> m_Integrators;
+    std::vector<std::uint32_t> m_Combs;
+
+    std::array<std::vector<float>, NumberOfChannels> m_Output;
+};
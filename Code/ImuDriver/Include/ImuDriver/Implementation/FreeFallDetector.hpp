@@ -1,7 +1,19 @@
 #pragma once
 
+#include "ImuDriver/Implementation/MotionSample.hpp"
+
 #include "ImuDriver/Interface/ImuDriver.hpp"
 
+#include <array>
+#include <cstddef>
+
+enum class FreeFallEvent
+{
+    None,
+    Started,
+    Finished,
+};
+
 class FreeFallDetector
     : public Interface::ImuDriver::NewDataAcquiredObserver
 {
@@ -17,12 +29,20 @@ public:
 
     void SubscribeToFreeFallDetection(FreeFallObserver& observer);
 
+    // Pipeline stage: subscribers are notified before the stages after it see the sample.
+    void Process(const MotionSample& sample);
+
 private:
     void OnNewDataAcquired(float ax, float ay, float az) override;
 
+    FreeFallEvent Detect(float ax, float ay, float az);
     bool AccelerationsAreSmall(float ax, float ay, float az);
+    void Notify(FreeFallEvent event);
+
+    static constexpr std::size_t MaxNumberOfObservers = 4;
 
     bool m_IsFreeFallInProgress = false;
     int m_CurrentFreeFallSamples = 0;
-    FreeFallObserver* m_FreeFallObserver = nullptr;
+    std::array<FreeFallObserver*, MaxNumberOfObservers> m_FreeFallObservers = {};
+    std::size_t m_NumberOfFreeFallObservers = 0;
 };
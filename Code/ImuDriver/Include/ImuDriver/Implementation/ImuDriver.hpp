@@ -1,8 +1,20 @@
 #pragma once
 
+#include "ImuDriver/Implementation/Calibration.hpp"
+
+#include "ImuDriver/Common/SeqLock.hpp"
+#include "ImuDriver/Common/SpscQueue.hpp"
+
+#include "ImuDriver/Interface/Clock.hpp"
 #include "ImuDriver/Interface/I2c.hpp"
 #include "ImuDriver/Interface/ImuDriver.hpp"
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
 #include <stop_token>
 #include <thread>
 
@@ -16,9 +28,10 @@ public:
         UnknownError,
     };
 
-    ImuDriver(Interface::I2c& i2c, Interface::I2c::SlaveAddress slaveAddress);
+    ImuDriver(Interface::I2c& i2c, Interface::I2c::SlaveAddress slaveAddress, Interface::Clock& clock);
 
     void SubscribeToNewDataAcquired(NewDataAcquiredObserver& observer) override;
+    void SubscribeToNewMotionDataAcquired(NewMotionDataAcquiredObserver& observer);
 
     Status Initialize();
 
@@ -40,29 +53,135 @@ public:
         Rate25Hz,
     };
 
+    // May be called from any thread, also during data acquisition. Other threads then hand
+    // the change to the acquisition thread, which applies it between two samples, and wait
+    // until it has been applied (or has failed); calls from observers running on the
+    // acquisition thread apply it right away. Samples acquired from then on are converted
+    // for the new range.
     Status ConfigureAccelerometer(AccelerometerScale scale, AccelerometerOutputDataRate outputDataRate);
 
+    // Applied to all samples converted from now on, cannot be changed while data acquisition is enabled.
+    Status SetCalibration(const ImuCalibration& calibration);
+    const ImuCalibration& GetCalibration() const;
+
+    struct ThreadConfiguration
+    {
+        enum class SchedulingPolicy
+        {
+            Default,
+            Fifo,
+            RoundRobin,
+        };
+
+        std::optional<int> cpu;
+        SchedulingPolicy schedulingPolicy = SchedulingPolicy::Default;
+        int priority = 0;
+        // Locks all current and future pages of the whole process in memory.
+        bool lockMemory = false;
+        std::size_t prefaultedStackSize = 0;
+        // Records how late the thread wakes up from each DRDY polling sleep.
+        bool measureJitter = false;
+    };
+
+    // Tells which of the requested settings the system granted when the thread started.
+    struct ThreadConfigurationResult
+    {
+        bool affinityGranted = true;
+        bool schedulingGranted = true;
+        bool memoryLocked = true;
+    };
+
+    struct JitterStatistics
+    {
+        std::uint64_t numberOfWakeUps = 0;
+        Interface::Clock::Duration minimum = Interface::Clock::Duration::max();
+        Interface::Clock::Duration maximum = Interface::Clock::Duration::zero();
+        Interface::Clock::Duration total = Interface::Clock::Duration::zero();
+    };
+
+    // Takes effect on the next Start().
+    Status SetThreadConfiguration(const ThreadConfiguration& configuration);
+    ThreadConfigurationResult GetThreadConfigurationResult() const;
+    // Describes the last acquisition run, valid once it is stopped.
+    JitterStatistics GetJitterStatistics() const;
+
+    struct LatestSample
+    {
+        Interface::Clock::TimePoint timestamp;
+        // Counted since construction, so 0 means that no sample has been acquired yet.
+        std::uint64_t sampleNumber;
+        std::uint64_t numberOfDataReadyPolls;
+        std::array<float, 3> acceleration;
+        std::array<float, 3> rotation;
+    };
+
+    // Wait-free for the acquisition thread and safe to call from any thread at any rate.
+    LatestSample GetLatestSample() const;
+
 private:
     Interface::I2c& m_I2c;
     Interface::I2c::SlaveAddress m_SlaveAddress;
+    Interface::Clock& m_Clock;
     std::jthread m_DataAcquisitionThread;
     std::stop_source m_StopSource;
     NewDataAcquiredObserver* m_NewDataAcquiredObserver = nullptr;
+    NewMotionDataAcquiredObserver* m_NewMotionDataAcquiredObserver = nullptr;
+    ThreadConfiguration m_ThreadConfiguration;
+    ThreadConfigurationResult m_ThreadConfigurationResult;
+    JitterStatistics m_JitterStatistics;
+    Common::SeqLock<LatestSample> m_LatestSample;
+    // Written by the data acquisition thread only.
+    std::uint64_t m_NumberOfSamples = 0;
+    std::uint64_t m_NumberOfDataReadyPolls = 0;
+
+    struct AccelerometerCommand
+    {
+        std::uint64_t id;
+        AccelerometerScale scale;
+        AccelerometerOutputDataRate outputDataRate;
+    };
+
+    // Configuration changes requested during data acquisition. Callers are serialised by
+    // the mutex, so there is a single producer; the acquisition thread is the consumer.
+    std::mutex m_CommandMutex;
+    std::uint64_t m_LastCommandId = 0;
+    Common::SpscQueue<AccelerometerCommand, 4> m_Commands;
+    // Id of the last handled command, shifted left by one, with the lowest bit set on failure.
+    std::atomic<std::uint64_t> m_CommandAcknowledgement = 0;
+    std::atomic<bool> m_IsAcquisitionThreadRunning = false;
+    // Default-constructed while no acquisition thread is running.
+    std::atomic<std::thread::id> m_AcquisitionThreadId;
+    float m_AccelerometerSensitivity;
+    Interface::Clock::Duration m_OutputDataPeriod;
+    ImuCalibration m_Calibration;
+    Conversion m_AccelerationConversion;
+    Conversion m_RotationConversion;
 
     void DataAcquisitionThread(std::stop_token stopToken);
+    void ApplyPendingCommands();
+    Status ReconfigureAccelerometerBetweenSamples(AccelerometerScale scale, AccelerometerOutputDataRate outputDataRate);
+    void FailPendingCommands();
+    void Acknowledge(std::uint64_t commandId, Status status);
+    Status SendAccelerometerCommand(AccelerometerScale scale, AccelerometerOutputDataRate outputDataRate);
+    Status WriteAccelerometerConfiguration(AccelerometerScale scale, AccelerometerOutputDataRate outputDataRate);
+    ThreadConfigurationResult ApplyThreadConfiguration() const;
+    void SleepUntilNextPoll();
 
     struct AcquiredData
     {
         using Accelerations = std::array<std::uint16_t, 3>;
+        using Rotations = std::array<std::uint16_t, 3>;
 
         Accelerations acceleration;
-        // std::array<std::uint16_t, 3> rotation;
+        Rotations rotation;
     };
     std::pair<Status, AcquiredData> ReadAllAcquiredData() const;
     std::pair<Status, std::uint16_t> ReadSingleAcquiredData(Register::Address& target) const;
 
-    std::array<float, 3> ConvertToFloat(const AcquiredData::Accelerations& acquired) const;
-    float ConvertToFloat(std::uint16_t acquired) const;
+    std::array<float, 3> ConvertAccelerations(const AcquiredData::Accelerations& acquired) const;
+    std::array<float, 3> ConvertRotations(const AcquiredData::Rotations& acquired) const;
+
+    Status ConfigureGyroscope();
 
     Status TurnOnAccelerometerAndGyroscopeInLowNoiseMode();
     Status TurnOffAccelerometerAndGyroscope();
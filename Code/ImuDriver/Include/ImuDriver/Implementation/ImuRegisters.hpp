@@ -11,8 +11,15 @@ constexpr auto ACCEL_DATA_Y1 = Address{0x0D};
 constexpr auto ACCEL_DATA_Y0 = Address{0x0E};
 constexpr auto ACCEL_DATA_Z1 = Address{0x0F};
 constexpr auto ACCEL_DATA_Z0 = Address{0x10};
+constexpr auto GYRO_DATA_X1 = Address{0x11};
+constexpr auto GYRO_DATA_X0 = Address{0x12};
+constexpr auto GYRO_DATA_Y1 = Address{0x13};
+constexpr auto GYRO_DATA_Y0 = Address{0x14};
+constexpr auto GYRO_DATA_Z1 = Address{0x15};
+constexpr auto GYRO_DATA_Z0 = Address{0x16};
 
 constexpr auto PWR_MGMT0 = Address{0x1F};
+constexpr auto GYRO_CONFIG0 = Address{0x20};
 constexpr auto ACCEL_CONFIG0 = Address{0x21};
 constexpr auto INT_STATUS_DRDY = Address{0x39};
 
@@ -33,6 +40,21 @@ constexpr auto ACCEL_UI_FS_SEL_2G  = std::uint8_t{0x03 << ACCEL_UI_FS_SEL_OFFSET
 constexpr auto ACCEL_ODR_50HZ = std::uint8_t{0x0A << ACCEL_ODR_OFFSET};
 constexpr auto ACCEL_ODR_25HZ = std::uint8_t{0x0B << ACCEL_ODR_OFFSET};
 
+// GYRO_CONFIG0
+constexpr auto GYRO_UI_FS_SEL_OFFSET = 5;
+constexpr auto GYRO_ODR_OFFSET       = 0;
+
+constexpr auto GYRO_UI_FS_SEL_MASK = std::uint8_t{0x03 << GYRO_UI_FS_SEL_OFFSET};
+constexpr auto GYRO_ODR_MASK       = std::uint8_t{0x0F << GYRO_ODR_OFFSET};
+
+constexpr auto GYRO_UI_FS_SEL_2000DPS = std::uint8_t{0x00 << GYRO_UI_FS_SEL_OFFSET};
+constexpr auto GYRO_UI_FS_SEL_1000DPS = std::uint8_t{0x01 << GYRO_UI_FS_SEL_OFFSET};
+constexpr auto GYRO_UI_FS_SEL_500DPS  = std::uint8_t{0x02 << GYRO_UI_FS_SEL_OFFSET};
+constexpr auto GYRO_UI_FS_SEL_250DPS  = std::uint8_t{0x03 << GYRO_UI_FS_SEL_OFFSET};
+
+constexpr auto GYRO_ODR_50HZ = std::uint8_t{0x0A << GYRO_ODR_OFFSET};
+constexpr auto GYRO_ODR_25HZ = std::uint8_t{0x0B << GYRO_ODR_OFFSET};
+
 // PWR_MGMT0
 constexpr auto GYRO_MODE_OFFSET  = 2;
 constexpr auto ACCEL_MODE_OFFSET = 0;
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <array>
+
+// Sample passed down a Pipeline. Stages may modify it for the stages after them.
+struct MotionSample
+{
+    std::array<float, 3> acceleration;
+    std::array<float, 3> rotation;
+};
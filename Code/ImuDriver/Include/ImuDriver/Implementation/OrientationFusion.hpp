@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ImuDriver/Implementation/MotionSample.hpp"
+
+#include "ImuDriver/Common/SeqLock.hpp"
+#include "ImuDriver/Interface/ImuDriver.hpp"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Estimates orientations of many IMUs at once. State of all devices is kept in
+// structure-of-arrays layout and advanced with one vectorised pass per tick, instead
+// of running a separate filter object per device.
+class OrientationFusion
+{
+public:
+    enum class Status
+    {
+        Success,
+        InvalidDevice,
+    };
+
+    enum class Algorithm
+    {
+        // Gyroscope integration, pulled towards gravity measured by the accelerometer (Mahony).
+        Complementary,
+        // Gradient descent orientation filter (Madgwick), IMU variant without magnetometer.
+        Madgwick,
+    };
+
+    struct Quaternion
+    {
+        float w;
+        float x;
+        float y;
+        float z;
+    };
+
+    // Feeds the samples of one IMU into one device slot of the engine, either subscribed
+    // to the driver or as the stage of a Pipeline.
+    class Input
+        : public Interface::ImuDriver::NewMotionDataAcquiredObserver
+    {
+    public:
+        Input(OrientationFusion& fusion, std::size_t device);
+
+        // Pipeline stage.
+        void Process(const MotionSample& sample);
+
+    private:
+        void OnNewMotionDataAcquired(float ax, float ay, float az, float gx, float gy, float gz) override;
+
+        OrientationFusion& m_Fusion;
+        std::size_t m_Device;
+    };
+
+    // Gain is proportional gain for the complementary filter and beta for Madgwick.
+    OrientationFusion(std::size_t numberOfDevices, Algorithm algorithm, float gain);
+
+    // May be called from the acquisition thread of the device, never blocks Step().
+    // Accelerations are in g, angular rates in degrees per second.
+    Status SetInput(std::size_t device, float ax, float ay, float az, float gx, float gy, float gz);
+
+    // Advances all devices by `period` seconds, using their most recent inputs.
+    void Step(float period);
+
+    Quaternion GetOrientation(std::size_t device) const;
+    std::size_t GetNumberOfDevices() const;
+
+private:
+    enum Component
+    {
+        Qw, Qx, Qy, Qz,
+        Ax, Ay, Az,
+        Gx, Gy, Gz,
+        NumberOfComponents,
+    };
+
+    void GatherInputs();
+    void StepComplementary(float period);
+    void StepMadgwick(float period);
+
+    std::size_t m_NumberOfDevices;
+    Algorithm m_Algorithm;
+    float m_Gain;
+
+    std::vector<Common::SeqLock<MotionSample>> m_Inputs;
+
+    // One array per component, padded to a whole number of SIMD vectors.
+    std::array<std::vector<float>, NumberOfComponents> m_State;
+};
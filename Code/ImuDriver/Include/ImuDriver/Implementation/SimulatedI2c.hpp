@@ -2,12 +2,15 @@
 
 #include "ImuDriver/Interface/I2c.hpp"
 
+#include <array>
 #include <string>
+#include <string_view>
 
 class SimulatedI2c
     : public Interface::I2c
 {
 public:
+    // Connects to the simulator at `endpoint` ("address:port"), or at 127.0.0.1:5555 when empty.
     SimulatedI2c(const std::string& endpoint);
     ~SimulatedI2c();
 
@@ -17,5 +20,8 @@ public:
 private:
     int m_Socket;
 
-    std::string SendAndReceive(const std::string& toBeSent) const;
+    using Message = std::array<char, 256>;
+
+    // Works on caller-provided buffers, so a transaction does not touch the heap.
+    std::string_view SendAndReceive(const Message& toBeSent, std::size_t size, Message& response) const;
 };
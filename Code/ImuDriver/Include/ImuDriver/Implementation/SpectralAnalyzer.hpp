@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ImuDriver/Common/SeqLock.hpp"
+#include "ImuDriver/Interface/ImuDriver.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Estimates vibration spectra of the accelerations of one IMU with a bank of Goertzel
+// filters, one per frequency of interest. Windows overlap and are Hann-weighted; every
+// window in flight is advanced with each incoming sample (vectorised across bins), so the
+// work is spread evenly over samples instead of being done in bursts at window ends.
+// The spectrum of the most recently completed window is published without blocking.
+// A running mean is removed from each axis first, so that gravity and sensor offsets do
+// not leak into the low bins (a bin at 0 Hz therefore only shows slow changes).
+class SpectralAnalyzer
+    : public Interface::ImuDriver::NewDataAcquiredObserver
+{
+public:
+    enum class Status
+    {
+        Success,
+        InvalidConfiguration,
+    };
+
+    static constexpr std::size_t MaxNumberOfBins = 32;
+
+    struct Configuration
+    {
+        float sampleRate = 50.0f;
+        std::size_t windowSize = 64;
+        // Samples between starts of consecutive windows, has to divide the window size.
+        std::size_t hopSize = 16;
+        std::vector<float> binFrequencies = {1.0f, 2.0f, 4.0f, 8.0f, 12.0f, 16.0f, 20.0f, 24.0f};
+    };
+
+    struct Spectrum
+    {
+        // Counted since configuration, so 0 means that no window has been completed yet.
+        std::uint64_t windowNumber;
+        std::size_t numberOfBins;
+        // Amplitude (in g) of each bin, per axis.
+        std::array<std::array<float, MaxNumberOfBins>, 3> amplitude;
+        // Sum of squared amplitudes of all bins, per axis.
+        std::array<float, 3> bandEnergy;
+        // Frequency of the bin with the largest amplitude, per axis.
+        std::array<float, 3> dominantFrequency;
+    };
+
+    SpectralAnalyzer();
+
+    // Must not be called while the upstream IMU delivers data.
+    Status Configure(const Configuration& configuration);
+
+    // Safe to call from any thread at any rate.
+    Spectrum GetSpectrum() const;
+
+private:
+    void OnNewDataAcquired(float ax, float ay, float az) override;
+
+    void PublishWindow(std::size_t window);
+
+    Configuration m_Configuration;
+    std::size_t m_PaddedNumberOfBins = 0;
+    std::size_t m_NumberOfWindows = 0;
+
+    std::vector<float> m_Window;
+    // 2 cos(2 pi f / fs) per bin, zero-padded to a whole number of SIMD vectors.
+    std::vector<float> m_Coefficients;
+    // Converts Goertzel magnitudes into amplitudes, per bin.
+    std::vector<float> m_AmplitudeScales;
+
+    // Exponential moving average per axis, starting at the first sample.
+    std::array<float, 3> m_Mean = {};
+    float m_MeanWeight = 0.0f;
+
+    // Goertzel state (last two outputs) per window in flight, axis and bin.
+    std::vector<float> m_Previous;
+    std::vector<float> m_BeforePrevious;
+    std::size_t m_SampleNumber = 0;
+    std::uint64_t m_WindowNumber = 0;
+
+    Common::SeqLock<Spectrum> m_Spectrum;
+};
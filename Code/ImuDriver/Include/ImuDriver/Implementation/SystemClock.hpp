@@ -0,0 +1,12 @@
+#pragma once
+
+#include "ImuDriver/Interface/Clock.hpp"
+
+class SystemClock
+    : public Interface::Clock
+{
+public:
+    TimePoint Now() const override;
+    void SleepFor(Duration duration) override;
+    void AdvanceTo(TimePoint timePoint) override;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ImuDriver/Interface/Clock.hpp"
+
+#include <atomic>
+
+// Simulated time which never waits: sleeping jumps straight to the moment the sleep
+// would end. Lets the same timing logic run deterministically at CPU speed.
+class VirtualClock
+    : public Interface::Clock
+{
+public:
+    TimePoint Now() const override;
+    void SleepFor(Duration duration) override;
+    // Does nothing if the time point is already in the past.
+    void AdvanceTo(TimePoint timePoint) override;
+
+private:
+    std::atomic<Duration::rep> m_Now = 0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+
+namespace Interface
+{
+
+class Clock
+{
+public:
+    using Duration = std::chrono::nanoseconds;
+    using TimePoint = std::chrono::time_point<std::chrono::steady_clock, Duration>;
+
+    virtual TimePoint Now() const = 0;
+    virtual void SleepFor(Duration duration) = 0;
+    // Jumps forward to the given time point where time can be skipped (simulated time).
+    // Real time cannot be skipped, so real clocks ignore it and the caller has to wait.
+    virtual void AdvanceTo(TimePoint timePoint) = 0;
+
+    virtual ~Clock() = default;
+};
+
+}
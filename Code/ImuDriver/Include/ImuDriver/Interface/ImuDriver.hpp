@@ -14,6 +14,15 @@ public:
         virtual ~NewDataAcquiredObserver() = default;
     };
 
+    // Receives accelerations (in g) together with angular rates (in degrees per second).
+    class NewMotionDataAcquiredObserver
+    {
+    public:
+        virtual void OnNewMotionDataAcquired(float ax, float ay, float az, float gx, float gy, float gz) = 0;
+
+        virtual ~NewMotionDataAcquiredObserver() = default;
+    };
+
     virtual void SubscribeToNewDataAcquired(NewDataAcquiredObserver& observer) = 0;
 
     virtual ~ImuDriver() = default;
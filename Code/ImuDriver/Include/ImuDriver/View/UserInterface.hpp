@@ -1,5 +1,6 @@
 #pragma once
 
+class CalibrationEstimator;
 class ImuDriver;
 
 namespace View
@@ -14,11 +15,18 @@ public:
         UnknownError,
     };
 
-    explicit UserInterface(ImuDriver& imu);
+    UserInterface(ImuDriver& imu, CalibrationEstimator& calibrationEstimator);
     Status RunMainLoop();
 
 private:
     ImuDriver& m_Imu;
+    CalibrationEstimator& m_CalibrationEstimator;
+
+    void ShowLatestSample() const;
+    void ShowThreadConfigurationResult() const;
+    void ShowJitterStatistics() const;
+    Status StartCalibration();
+    Status SaveCalibration();
 };
 
 }
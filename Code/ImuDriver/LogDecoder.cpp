@@ -0,0 +1,191 @@
+#include "ImuDriver/Common/BinaryLogger.hpp"
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Log::Binary;
+
+namespace
+{
+
+struct FormatDefinition
+{
+    Level level;
+    std::string format;
+    std::vector<ArgumentType> arguments;
+};
+
+std::string_view AsPrefix(const Level level)
+{
+    switch (level)
+    {
+    case Level::Debug: return "[DEBUG] ";
+    case Level::Info:  return "[INFO]  ";
+    case Level::Error: return "[ERROR] ";
+    }
+
+    return "[?????] ";
+}
+
+template<typename T>
+bool ReadValue(std::istream& input, T& value)
+{
+    return static_cast<bool>(input.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+template<typename T>
+std::string FormatArgument(const std::string& specification, const std::byte* source)
+{
+    auto value = T{};
+    std::memcpy(&value, source, sizeof(value));
+    return std::vformat("{" + specification + "}", std::make_format_args(value));
+}
+
+std::string FormatArgument(const std::string& specification, const ArgumentType type, const std::byte* source)
+{
+    using Detail::Stored;
+    switch (type)
+    {
+    case ArgumentType::Bool:   return FormatArgument<Stored<ArgumentType::Bool>>(specification, source);
+    case ArgumentType::Int32:  return FormatArgument<Stored<ArgumentType::Int32>>(specification, source);
+    case ArgumentType::UInt32: return FormatArgument<Stored<ArgumentType::UInt32>>(specification, source);
+    case ArgumentType::Int64:  return FormatArgument<Stored<ArgumentType::Int64>>(specification, source);
+    case ArgumentType::UInt64: return FormatArgument<Stored<ArgumentType::UInt64>>(specification, source);
+    case ArgumentType::Float:  return FormatArgument<Stored<ArgumentType::Float>>(specification, source);
+    case ArgumentType::Double: return FormatArgument<Stored<ArgumentType::Double>>(specification, source);
+    }
+
+    return "?";
+}
+
+// Replacement fields are taken in order; explicit argument indices are not supported.
+std::string FormatMessage(const FormatDefinition& definition, const std::vector<std::byte>& arguments)
+{
+    auto message = std::string{};
+    auto argumentIndex = std::size_t{0};
+    auto argumentOffset = std::size_t{0};
+
+    const auto& format = definition.format;
+    for (std::size_t i = 0; i < format.size(); ++i)
+    {
+        if ((format[i] == '{' or format[i] == '}') and i + 1 < format.size() and format[i + 1] == format[i])
+        {
+            message += format[i++];
+            continue;
+        }
+
+        if (format[i] != '{')
+        {
+            message += format[i];
+            continue;
+        }
+
+        const auto end = format.find('}', i);
+        if (end == std::string::npos or argumentIndex >= definition.arguments.size())
+        {
+            message += format.substr(i);
+            break;
+        }
+
+        const auto field = format.substr(i + 1, end - i - 1);
+        const auto colon = field.find(':');
+        const auto specification = colon == std::string::npos ? std::string{} : field.substr(colon);
+
+        const auto type = definition.arguments[argumentIndex++];
+        message += FormatArgument(specification, type, arguments.data() + argumentOffset);
+        argumentOffset += Detail::SizeOf(type);
+        i = end;
+    }
+
+    return message;
+}
+
+}
+
+// Converts binary logs (see Log::Binary) into the text format of regular logs.
+int main(int argc, char *argv[])
+{
+    const auto path = argc > 1 ? argv[1] : FileName;
+    auto input = std::ifstream{path, std::ios::binary};
+    if (not input)
+    {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+
+    auto definitions = std::vector<FormatDefinition>{};
+    // Wall clock and logging clock time at the start of the session.
+    auto sessionStart = std::int64_t{};
+    auto sessionClockStart = std::int64_t{};
+    auto magic = FileMagic;
+    while (input.read(magic.data(), 1))
+    {
+        // A new session starts with the magic, the record kind byte can never equal its first character.
+        if (magic[0] == FileMagic[0])
+        {
+            if (not input.read(magic.data() + 1, magic.size() - 1) or magic != FileMagic
+                or not ReadValue(input, sessionStart) or not ReadValue(input, sessionClockStart))
+            {
+                std::cerr << "Corrupted session header" << std::endl;
+                return 1;
+            }
+            definitions.clear();
+            continue;
+        }
+
+        const auto kind = static_cast<RecordKind>(magic[0]);
+        auto id = FormatId{};
+        if (not ReadValue(input, id))
+        {
+            break;
+        }
+
+        if (kind == RecordKind::FormatDefinition)
+        {
+            auto definition = FormatDefinition{};
+            auto numberOfArguments = std::uint8_t{};
+            auto length = std::uint16_t{};
+            ReadValue(input, definition.level);
+            ReadValue(input, numberOfArguments);
+            definition.arguments.resize(numberOfArguments);
+            input.read(reinterpret_cast<char*>(definition.arguments.data()), numberOfArguments);
+            ReadValue(input, length);
+            definition.format.resize(length);
+            input.read(definition.format.data(), length);
+
+            definitions.resize(std::max<std::size_t>(definitions.size(), id + 1));
+            definitions[id] = std::move(definition);
+            continue;
+        }
+
+        if (kind != RecordKind::Message or id >= definitions.size())
+        {
+            std::cerr << "Corrupted record" << std::endl;
+            return 1;
+        }
+
+        auto timestamp = std::int64_t{};
+        ReadValue(input, timestamp);
+
+        const auto& definition = definitions[id];
+        auto size = std::size_t{0};
+        for (const auto type : definition.arguments)
+        {
+            size += Detail::SizeOf(type);
+        }
+        auto arguments = std::vector<std::byte>(size);
+        if (not input.read(reinterpret_cast<char*>(arguments.data()), size))
+        {
+            break;
+        }
+
+        const auto time = std::chrono::sys_time<std::chrono::nanoseconds>{std::chrono::nanoseconds{sessionStart + timestamp - sessionClockStart}};
+        std::cout << AsPrefix(definition.level) << std::format("[{:%F %T}] ", time) << FormatMessage(definition, arguments) << '\n';
+    }
+
+    return 0;
+}
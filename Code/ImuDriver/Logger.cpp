@@ -8,8 +8,6 @@ namespace Log
 namespace
 {
 
-constexpr auto DebugLogsEnabled = false;
-
 void CreateLog(const Message& message)
 {
     std::ofstream(FileName, std::ios::app) << message << std::endl;
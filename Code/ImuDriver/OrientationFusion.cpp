@@ -0,0 +1,230 @@
+#include "ImuDriver/Implementation/OrientationFusion.hpp"
+
+#include "ImuDriver/Common/Simd.hpp"
+
+#include <numbers>
+
+using namespace Common;
+
+namespace
+{
+
+constexpr auto DegreesToRadians = std::numbers::pi_v<float> / 180.0f;
+
+// Squared norms below this are treated as zero (e.g. no data yet, or free fall).
+constexpr auto NegligibleSquaredNorm = 1e-12f;
+
+}
+
+OrientationFusion::Input::Input(OrientationFusion& fusion, const std::size_t device)
+    : m_Fusion{fusion}
+    , m_Device{device}
+{
+}
+
+void OrientationFusion::Input::Process(const MotionSample& sample)
+{
+    const auto& [acceleration, rotation] = sample;
+    m_Fusion.SetInput(m_Device, acceleration[0], acceleration[1], acceleration[2], rotation[0], rotation[1], rotation[2]);
+}
+
+void OrientationFusion::Input::OnNewMotionDataAcquired(const float ax, const float ay, const float az, const float gx, const float gy, const float gz)
+{
+    Process({{ax, ay, az}, {gx, gy, gz}});
+}
+
+OrientationFusion::OrientationFusion(const std::size_t numberOfDevices, const Algorithm algorithm, const float gain)
+    : m_NumberOfDevices{numberOfDevices}
+    , m_Algorithm{algorithm}
+    , m_Gain{gain}
+    , m_Inputs(numberOfDevices)
+{
+    for (auto& component : m_State)
+    {
+        component.assign(Simd::PaddedSize(numberOfDevices), 0.0f);
+    }
+    m_State[Qw].assign(m_State[Qw].size(), 1.0f);
+}
+
+OrientationFusion::Status OrientationFusion::SetInput(const std::size_t device, const float ax, const float ay, const float az, const float gx, const float gy, const float gz)
+{
+    if (device >= m_NumberOfDevices)
+    {
+        return Status::InvalidDevice;
+    }
+
+    m_Inputs[device].Write({{ax, ay, az}, {gx, gy, gz}});
+    return Status::Success;
+}
+
+void OrientationFusion::Step(const float period)
+{
+    GatherInputs();
+
+    switch (m_Algorithm)
+    {
+    case Algorithm::Complementary: StepComplementary(period); break;
+    case Algorithm::Madgwick:      StepMadgwick(period); break;
+    }
+}
+
+OrientationFusion::Quaternion OrientationFusion::GetOrientation(const std::size_t device) const
+{
+    return {m_State[Qw][device], m_State[Qx][device], m_State[Qy][device], m_State[Qz][device]};
+}
+
+std::size_t OrientationFusion::GetNumberOfDevices() const
+{
+    return m_NumberOfDevices;
+}
+
+void OrientationFusion::GatherInputs()
+{
+    for (std::size_t device = 0; device < m_NumberOfDevices; ++device)
+    {
+        const auto [acceleration, rotation] = m_Inputs[device].Read();
+        m_State[Ax][device] = acceleration[0];
+        m_State[Ay][device] = acceleration[1];
+        m_State[Az][device] = acceleration[2];
+        m_State[Gx][device] = rotation[0] * DegreesToRadians;
+        m_State[Gy][device] = rotation[1] * DegreesToRadians;
+        m_State[Gz][device] = rotation[2] * DegreesToRadians;
+    }
+}
+
+void OrientationFusion::StepComplementary(const float period)
+{
+    using Simd::Broadcast;
+
+    const auto one = Broadcast(1.0f);
+    const auto two = Broadcast(2.0f);
+    const auto half = Broadcast(0.5f);
+    const auto gain = Broadcast(m_Gain);
+    const auto dt = Broadcast(period);
+    const auto negligible = Broadcast(NegligibleSquaredNorm);
+
+    for (std::size_t i = 0; i < m_State[Qw].size(); i += Simd::Width)
+    {
+        auto q0 = Simd::Load(m_State[Qw].data() + i);
+        auto q1 = Simd::Load(m_State[Qx].data() + i);
+        auto q2 = Simd::Load(m_State[Qy].data() + i);
+        auto q3 = Simd::Load(m_State[Qz].data() + i);
+        auto ax = Simd::Load(m_State[Ax].data() + i);
+        auto ay = Simd::Load(m_State[Ay].data() + i);
+        auto az = Simd::Load(m_State[Az].data() + i);
+        auto gx = Simd::Load(m_State[Gx].data() + i);
+        auto gy = Simd::Load(m_State[Gy].data() + i);
+        auto gz = Simd::Load(m_State[Gz].data() + i);
+
+        // Correct angular rates by the error between measured and estimated gravity direction.
+        const auto accelerationNorm = ax * ax + ay * ay + az * az;
+        const auto correction = gain * Simd::Greater(accelerationNorm, negligible);
+        const auto reciprocalNorm = one / Simd::Sqrt(Simd::Max(accelerationNorm, negligible));
+        ax = ax * reciprocalNorm;
+        ay = ay * reciprocalNorm;
+        az = az * reciprocalNorm;
+
+        const auto vx = two * (q1 * q3 - q0 * q2);
+        const auto vy = two * (q0 * q1 + q2 * q3);
+        const auto vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+
+        gx = Simd::MultiplyAdd(correction, ay * vz - az * vy, gx);
+        gy = Simd::MultiplyAdd(correction, az * vx - ax * vz, gy);
+        gz = Simd::MultiplyAdd(correction, ax * vy - ay * vx, gz);
+
+        const auto qDot0 = half * (Simd::Zero() - q1 * gx - q2 * gy - q3 * gz);
+        const auto qDot1 = half * (q0 * gx + q2 * gz - q3 * gy);
+        const auto qDot2 = half * (q0 * gy - q1 * gz + q3 * gx);
+        const auto qDot3 = half * (q0 * gz + q1 * gy - q2 * gx);
+
+        q0 = Simd::MultiplyAdd(qDot0, dt, q0);
+        q1 = Simd::MultiplyAdd(qDot1, dt, q1);
+        q2 = Simd::MultiplyAdd(qDot2, dt, q2);
+        q3 = Simd::MultiplyAdd(qDot3, dt, q3);
+
+        const auto reciprocalQuaternionNorm = one / Simd::Sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        Simd::Store(m_State[Qw].data() + i, q0 * reciprocalQuaternionNorm);
+        Simd::Store(m_State[Qx].data() + i, q1 * reciprocalQuaternionNorm);
+        Simd::Store(m_State[Qy].data() + i, q2 * reciprocalQuaternionNorm);
+        Simd::Store(m_State[Qz].data() + i, q3 * reciprocalQuaternionNorm);
+    }
+}
+
+void OrientationFusion::StepMadgwick(const float period)
+{
+    using Simd::Broadcast;
+
+    const auto one = Broadcast(1.0f);
+    const auto two = Broadcast(2.0f);
+    const auto four = Broadcast(4.0f);
+    const auto eight = Broadcast(8.0f);
+    const auto half = Broadcast(0.5f);
+    const auto beta = Broadcast(m_Gain);
+    const auto dt = Broadcast(period);
+    const auto negligible = Broadcast(NegligibleSquaredNorm);
+
+    for (std::size_t i = 0; i < m_State[Qw].size(); i += Simd::Width)
+    {
+        auto q0 = Simd::Load(m_State[Qw].data() + i);
+        auto q1 = Simd::Load(m_State[Qx].data() + i);
+        auto q2 = Simd::Load(m_State[Qy].data() + i);
+        auto q3 = Simd::Load(m_State[Qz].data() + i);
+        auto ax = Simd::Load(m_State[Ax].data() + i);
+        auto ay = Simd::Load(m_State[Ay].data() + i);
+        auto az = Simd::Load(m_State[Az].data() + i);
+        const auto gx = Simd::Load(m_State[Gx].data() + i);
+        const auto gy = Simd::Load(m_State[Gy].data() + i);
+        const auto gz = Simd::Load(m_State[Gz].data() + i);
+
+        // Rate of change of the quaternion from the gyroscope.
+        auto qDot0 = half * (Simd::Zero() - q1 * gx - q2 * gy - q3 * gz);
+        auto qDot1 = half * (q0 * gx + q2 * gz - q3 * gy);
+        auto qDot2 = half * (q0 * gy - q1 * gz + q3 * gx);
+        auto qDot3 = half * (q0 * gz + q1 * gy - q2 * gx);
+
+        const auto accelerationNorm = ax * ax + ay * ay + az * az;
+        const auto accelerationIsValid = Simd::Greater(accelerationNorm, negligible);
+        const auto reciprocalNorm = one / Simd::Sqrt(Simd::Max(accelerationNorm, negligible));
+        ax = ax * reciprocalNorm;
+        ay = ay * reciprocalNorm;
+        az = az * reciprocalNorm;
+
+        // Gradient of the objective function aligning estimated and measured gravity.
+        const auto _2q0 = two * q0;
+        const auto _2q1 = two * q1;
+        const auto _2q2 = two * q2;
+        const auto _2q3 = two * q3;
+        const auto _4q0 = four * q0;
+        const auto _4q1 = four * q1;
+        const auto _4q2 = four * q2;
+        const auto _8q1 = eight * q1;
+        const auto _8q2 = eight * q2;
+        const auto q0q0 = q0 * q0;
+        const auto q1q1 = q1 * q1;
+        const auto q2q2 = q2 * q2;
+        const auto q3q3 = q3 * q3;
+
+        const auto s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        const auto s1 = _4q1 * q3q3 - _2q3 * ax + four * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az;
+        const auto s2 = four * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az;
+        const auto s3 = four * q1q1 * q3 - _2q1 * ax + four * q2q2 * q3 - _2q2 * ay;
+
+        const auto stepNorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        const auto step = accelerationIsValid * beta / Simd::Sqrt(Simd::Max(stepNorm, negligible));
+        qDot0 = qDot0 - step * s0;
+        qDot1 = qDot1 - step * s1;
+        qDot2 = qDot2 - step * s2;
+        qDot3 = qDot3 - step * s3;
+
+        q0 = Simd::MultiplyAdd(qDot0, dt, q0);
+        q1 = Simd::MultiplyAdd(qDot1, dt, q1);
+        q2 = Simd::MultiplyAdd(qDot2, dt, q2);
+        q3 = Simd::MultiplyAdd(qDot3, dt, q3);
+
+        const auto reciprocalQuaternionNorm = one / Simd::Sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        Simd::Store(m_State[Qw].data() + i, q0 * reciprocalQuaternionNorm);
+        Simd::Store(m_State[Qx].data() + i, q1 * reciprocalQuaternionNorm);
+        Simd::Store(m_State[Qy].data() + i, q2 * reciprocalQuaternionNorm);
+        Simd::Store(m_State[Qz].data() + i, q3 * reciprocalQuaternionNorm);
+    }
+}
@@ -7,17 +7,29 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <charconv>
 #include <format>
-#include <sstream>
+#include <stdexcept>
 
 using Interface::I2c;
 
 namespace Command
 {
 
-constexpr auto ReadByte =  std::string{"READ_BYTE"};
-constexpr auto WriteByte = std::string{"WRITE_BYTE"};
-constexpr auto Error    =  std::string{"ERROR"};
+constexpr auto ReadByte =  std::string_view{"READ_BYTE"};
+constexpr auto WriteByte = std::string_view{"WRITE_BYTE"};
+constexpr auto Error    =  std::string_view{"ERROR"};
+
+}
+
+namespace
+{
+
+constexpr auto HexPrefix = std::string_view{"0x"};
+
+// Where the simulator listens.
+constexpr auto DefaultHost = std::string_view{"127.0.0.1"};
+constexpr auto DefaultPort = std::uint16_t{5555};
 
 }
 
@@ -26,10 +38,22 @@ SimulatedI2c::SimulatedI2c(const std::string& endpoint)
 {
     if (m_Socket == -1) throw std::runtime_error{"Error occurred during socket creation"};
 
+    auto host = std::string{DefaultHost};
+    auto port = DefaultPort;
+    if (not endpoint.empty())
+    {
+        const auto separator = endpoint.rfind(':');
+        if (separator == std::string::npos or std::from_chars(endpoint.data() + separator + 1, endpoint.data() + endpoint.size(), port).ec != std::errc{})
+        {
+            throw std::runtime_error{"Endpoint has to be given as address:port"};
+        }
+        host = endpoint.substr(0, separator);
+    }
+
     auto hint = sockaddr_in{};
     hint.sin_family = AF_INET;
-    hint.sin_port = htons(5555);
-    inet_pton(AF_INET, "127.0.0.1", &hint.sin_addr);
+    hint.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &hint.sin_addr) != 1) throw std::runtime_error{"Invalid endpoint address"};
 
     if (connect(m_Socket, (sockaddr*)&hint, sizeof(hint)) == -1) throw std::runtime_error{"Error during connection creation"};
 }
@@ -42,21 +66,37 @@ SimulatedI2c::~SimulatedI2c()
 SimulatedI2c::ReadByteResult SimulatedI2c::ReadByte(SlaveAddress, const Register::Address source) const
 {
     ReadByteResult result{Status::UnknownError};
-    auto response = SendAndReceive(std::format("{} {}", Command::ReadByte, source.AsString()));
+
+    auto request = Message{};
+    const auto requestSize = std::format_to_n(request.data(), request.size() - 1, "{} 0x{:02x}", Command::ReadByte, source.m_Address).size;
+
+    auto responseBuffer = Message{};
+    auto response = SendAndReceive(request, static_cast<std::size_t>(requestSize), responseBuffer);
     if (response.starts_with(Command::Error))
     {
         return result;
     }
 
+    if (response.starts_with(HexPrefix))
+    {
+        response.remove_prefix(HexPrefix.size());
+    }
+    if (std::from_chars(response.data(), response.data() + response.size(), result.readByte, 16).ec != std::errc{})
+    {
+        return result;
+    }
+
     result.status = Status::Success;
-    result.readByte = static_cast<std::uint8_t>(std::stoi(response, nullptr, 16));
     return result;
 }
 
 I2c::Status SimulatedI2c::WriteByte(SlaveAddress, Register::Address source, std::uint8_t byte) const
 {
-    ReadByteResult result{Status::UnknownError};
-    auto response = SendAndReceive(std::format("{} {} 0x{:02x}", Command::WriteByte, source.AsString(), byte));
+    auto request = Message{};
+    const auto requestSize = std::format_to_n(request.data(), request.size() - 1, "{} 0x{:02x} 0x{:02x}", Command::WriteByte, source.m_Address, byte).size;
+
+    auto responseBuffer = Message{};
+    const auto response = SendAndReceive(request, static_cast<std::size_t>(requestSize), responseBuffer);
     if (response.starts_with(Command::Error))
     {
         return Status::UnknownError;
@@ -65,16 +105,23 @@ I2c::Status SimulatedI2c::WriteByte(SlaveAddress, Register::Address source, std:
     return Status::Success;
 }
 
-std::string SimulatedI2c::SendAndReceive(const std::string& toBeSent) const
+std::string_view SimulatedI2c::SendAndReceive(const Message& toBeSent, const std::size_t size, Message& response) const
 {
-    // Sent the message.
-    if (send(m_Socket, toBeSent.c_str(), toBeSent.size() + 1, 0) == -1) throw std::runtime_error{"Sending error"};
-    Log::Debug(std::format("    Sent: \"{}\"", toBeSent));
+    // Sent the message, including the terminating null character.
+    if (send(m_Socket, toBeSent.data(), size + 1, 0) == -1) throw std::runtime_error{"Sending error"};
+    if constexpr (Log::DebugLogsEnabled)
+    {
+        Log::Debug(std::format("    Sent: \"{}\"", std::string_view{toBeSent.data(), size}));
+    }
 
     // Receive the response.
-    auto response = std::array<char, 256>{};
-    auto bytesReceived = recv(m_Socket, response.data(), response.size(), 0);
+    auto bytesReceived = recv(m_Socket, response.data(), response.size() - 1, 0);
     if (bytesReceived == -1) throw std::runtime_error{"Receiving error"};
-    Log::Debug(std::format("Received: \"{}\"", response));
-    return response.data();
+
+    const auto received = std::string_view{response.data(), static_cast<std::size_t>(bytesReceived)};
+    if constexpr (Log::DebugLogsEnabled)
+    {
+        Log::Debug(std::format("Received: \"{}\"", received));
+    }
+    return received;
 }
@@ -0,0 +1,177 @@
+#include "ImuDriver/Implementation/SpectralAnalyzer.hpp"
+
+#include "ImuDriver/Common/Logger.hpp"
+#include "ImuDriver/Common/Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+using namespace Common;
+
+namespace
+{
+
+constexpr auto NumberOfAxes = std::size_t{3};
+
+}
+
+SpectralAnalyzer::SpectralAnalyzer()
+{
+    Configure(Configuration{});
+}
+
+SpectralAnalyzer::Status SpectralAnalyzer::Configure(const Configuration& configuration)
+{
+    const auto& [sampleRate, windowSize, hopSize, binFrequencies] = configuration;
+    if (not (sampleRate > 0.0f) or windowSize < 2 or hopSize == 0 or hopSize > windowSize or windowSize % hopSize != 0)
+    {
+        Log::Error(std::format("Invalid spectral analysis windows: {} samples every {} samples at {} Hz", windowSize, hopSize, sampleRate));
+        return Status::InvalidConfiguration;
+    }
+
+    if (binFrequencies.empty() or binFrequencies.size() > MaxNumberOfBins)
+    {
+        Log::Error(std::format("Invalid number of spectral analysis bins: {}, supported are 1 to {}", binFrequencies.size(), MaxNumberOfBins));
+        return Status::InvalidConfiguration;
+    }
+
+    const auto isOutOfRange = [sampleRate](const float frequency) { return not (frequency >= 0.0f and frequency <= sampleRate / 2); };
+    if (std::ranges::any_of(binFrequencies, isOutOfRange))
+    {
+        Log::Error(std::format("Spectral analysis bins have to lie between 0 and {} Hz", sampleRate / 2));
+        return Status::InvalidConfiguration;
+    }
+
+    m_Configuration = configuration;
+    m_PaddedNumberOfBins = Simd::PaddedSize(binFrequencies.size());
+    m_NumberOfWindows = windowSize / hopSize;
+
+    // Periodic Hann window, so that overlapping windows sum up to a constant.
+    m_Window.resize(windowSize);
+    for (std::size_t n = 0; n < windowSize; ++n)
+    {
+        m_Window[n] = static_cast<float>(0.5 - 0.5 * std::cos(2 * std::numbers::pi * n / windowSize));
+    }
+
+    // A sine of amplitude A yields A * sum(window) / 2 in its bin, a constant A * sum(window).
+    const auto windowSum = std::accumulate(m_Window.begin(), m_Window.end(), 0.0f);
+    m_AmplitudeScales.assign(m_PaddedNumberOfBins, 0.0f);
+    m_Coefficients.assign(m_PaddedNumberOfBins, 0.0f);
+    for (std::size_t bin = 0; bin < binFrequencies.size(); ++bin)
+    {
+        m_Coefficients[bin] = static_cast<float>(2 * std::cos(2 * std::numbers::pi * binFrequencies[bin] / sampleRate));
+        m_AmplitudeScales[bin] = (binFrequencies[bin] == 0.0f ? 1.0f : 2.0f) / windowSum;
+    }
+
+    // Averages over about one window, which attenuates a bin with one period per window
+    // by a few percent (2 % for 64 samples).
+    m_Mean = {};
+    m_MeanWeight = 1.0f / static_cast<float>(windowSize);
+
+    m_Previous.assign(m_NumberOfWindows * NumberOfAxes * m_PaddedNumberOfBins, 0.0f);
+    m_BeforePrevious.assign(m_Previous.size(), 0.0f);
+    m_SampleNumber = 0;
+    m_WindowNumber = 0;
+    m_Spectrum.Write(Spectrum{});
+
+    return Status::Success;
+}
+
+SpectralAnalyzer::Spectrum SpectralAnalyzer::GetSpectrum() const
+{
+    return m_Spectrum.Read();
+}
+
+void SpectralAnalyzer::OnNewDataAcquired(const float ax, const float ay, const float az)
+{
+    const auto windowSize = m_Configuration.windowSize;
+    const auto hopSize = m_Configuration.hopSize;
+    auto samples = std::array{ax, ay, az};
+    for (std::size_t axis = 0; axis < NumberOfAxes; ++axis)
+    {
+        m_Mean[axis] = m_SampleNumber == 0 ? samples[axis] : m_Mean[axis] + m_MeanWeight * (samples[axis] - m_Mean[axis]);
+        samples[axis] -= m_Mean[axis];
+    }
+
+    for (std::size_t window = 0; window < m_NumberOfWindows; ++window)
+    {
+        // Window k starts k hops after the first sample, then once per window size.
+        const auto start = window * hopSize;
+        if (m_SampleNumber < start)
+        {
+            break;
+        }
+
+        const auto position = (m_SampleNumber - start) % windowSize;
+        auto* previous = m_Previous.data() + window * NumberOfAxes * m_PaddedNumberOfBins;
+        auto* beforePrevious = m_BeforePrevious.data() + window * NumberOfAxes * m_PaddedNumberOfBins;
+        if (position == 0)
+        {
+            std::fill_n(previous, NumberOfAxes * m_PaddedNumberOfBins, 0.0f);
+            std::fill_n(beforePrevious, NumberOfAxes * m_PaddedNumberOfBins, 0.0f);
+        }
+
+        for (std::size_t axis = 0; axis < NumberOfAxes; ++axis)
+        {
+            const auto weighted = Simd::Broadcast(samples[axis] * m_Window[position]);
+            for (std::size_t bin = 0; bin < m_PaddedNumberOfBins; bin += Simd::Width)
+            {
+                const auto offset = axis * m_PaddedNumberOfBins + bin;
+                const auto last = Simd::Load(previous + offset);
+                const auto current = Simd::MultiplyAdd(Simd::Load(m_Coefficients.data() + bin), last, weighted - Simd::Load(beforePrevious + offset));
+                Simd::Store(beforePrevious + offset, last);
+                Simd::Store(previous + offset, current);
+            }
+        }
+
+        if (position == windowSize - 1)
+        {
+            PublishWindow(window);
+        }
+    }
+
+    ++m_SampleNumber;
+}
+
+void SpectralAnalyzer::PublishWindow(const std::size_t window)
+{
+    const auto& binFrequencies = m_Configuration.binFrequencies;
+    const auto* previous = m_Previous.data() + window * NumberOfAxes * m_PaddedNumberOfBins;
+    const auto* beforePrevious = m_BeforePrevious.data() + window * NumberOfAxes * m_PaddedNumberOfBins;
+
+    auto spectrum = Spectrum{};
+    spectrum.windowNumber = ++m_WindowNumber;
+    spectrum.numberOfBins = binFrequencies.size();
+
+    for (std::size_t axis = 0; axis < NumberOfAxes; ++axis)
+    {
+        // |X|^2 = s1^2 + s2^2 - coefficient * s1 * s2, vectorised across bins like the update.
+        auto amplitudes = std::array<float, Simd::PaddedSize(MaxNumberOfBins)>{};
+        for (std::size_t bin = 0; bin < m_PaddedNumberOfBins; bin += Simd::Width)
+        {
+            const auto offset = axis * m_PaddedNumberOfBins + bin;
+            const auto s1 = Simd::Load(previous + offset);
+            const auto s2 = Simd::Load(beforePrevious + offset);
+            const auto power = Simd::MultiplyAdd(s1, s1 - Simd::Load(m_Coefficients.data() + bin) * s2, s2 * s2);
+            const auto magnitude = Simd::Sqrt(Simd::Max(power, Simd::Zero()));
+            Simd::Store(amplitudes.data() + bin, magnitude * Simd::Load(m_AmplitudeScales.data() + bin));
+        }
+
+        auto dominantBin = std::size_t{0};
+        for (std::size_t bin = 0; bin < binFrequencies.size(); ++bin)
+        {
+            const auto amplitude = amplitudes[bin];
+            spectrum.amplitude[axis][bin] = amplitude;
+            spectrum.bandEnergy[axis] += amplitude * amplitude;
+            if (amplitude > amplitudes[dominantBin])
+            {
+                dominantBin = bin;
+            }
+        }
+        spectrum.dominantFrequency[axis] = binFrequencies[dominantBin];
+    }
+
+    m_Spectrum.Write(spectrum);
+}
@@ -0,0 +1,17 @@
+#include "ImuDriver/Implementation/SystemClock.hpp"
+
+#include <thread>
+
+SystemClock::TimePoint SystemClock::Now() const
+{
+    return std::chrono::time_point_cast<Duration>(std::chrono::steady_clock::now());
+}
+
+void SystemClock::SleepFor(const Duration duration)
+{
+    std::this_thread::sleep_for(duration);
+}
+
+void SystemClock::AdvanceTo(TimePoint)
+{
+}
@@ -0,0 +1,300 @@
+#include "ImuDriver/Implementation/BlackBoxRecorder.hpp"
+#include "ImuDriver/Implementation/FreeFallDetector.hpp"
+#include "ImuDriver/Implementation/FreeFallLogger.hpp"
+#include "ImuDriver/Implementation/ImuDriver.hpp"
+#include "ImuDriver/Implementation/ImuRegisters.hpp"
+#include "ImuDriver/Implementation/Pipeline.hpp"
+#include "ImuDriver/Implementation/SimulatedI2c.hpp"
+#include "ImuDriver/Implementation/VirtualClock.hpp"
+
+#include "ImuDriver/Common/AllocationCounter.hpp"
+#include "ImuDriver/Common/BinaryLogger.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Runs samples through ImuDriver and the processing pipeline and checks that the data
+// acquisition thread does not touch the heap once it is warmed up. The device is read
+// once directly and once through SimulatedI2c, which talks to it over a socket.
+namespace
+{
+
+static_assert(Common::Allocations::CountingEnabled, "Build with IMU_DRIVER_COUNT_ALLOCATIONS");
+
+constexpr auto NumberOfSamples = std::uint64_t{5000};
+// The first sample only sets the baseline of the allocation count.
+constexpr auto WarmUpSamples = std::uint64_t{1};
+
+// Every FreeFallPeriod samples the device falls for FreeFallSamples samples, so that
+// free fall detection, logging and black box dumps are exercised too.
+constexpr auto FreeFallPeriod = std::uint64_t{500};
+constexpr auto FreeFallSamples = std::uint64_t{30};
+
+// ±2 g, the range selected by ImuDriver::Initialize().
+constexpr auto AccelerometerSensitivity = 16384;
+
+constexpr auto BlackBoxConfiguration = BlackBoxRecorder::Configuration{
+    .preTriggerSamples = 100,
+    .postTriggerSamples = 50,
+};
+
+// Register map of a device which has data ready on every other poll. Reading the first
+// data register latches the next sample.
+class FakeI2c
+    : public Interface::I2c
+{
+public:
+    FakeI2c()
+    {
+        // Reset value.
+        m_Registers[Register::ACCEL_CONFIG0.m_Address] = 0x06;
+    }
+
+    ReadByteResult ReadByte(SlaveAddress, const Register::Address source) const override
+    {
+        if (source.m_Address == Register::INT_STATUS_DRDY.m_Address)
+        {
+            m_IsDataReady = not m_IsDataReady;
+            return {Status::Success, m_IsDataReady ? DATA_RDY_INT_DATA_IS_READY : std::uint8_t{0}};
+        }
+        if (source.m_Address == Register::ACCEL_DATA_X1.m_Address)
+        {
+            LatchNextSample();
+        }
+
+        return {Status::Success, m_Registers[source.m_Address]};
+    }
+
+    Status WriteByte(SlaveAddress, const Register::Address source, const std::uint8_t byte) const override
+    {
+        m_Registers[source.m_Address] = byte;
+        return Status::Success;
+    }
+
+private:
+    void LatchNextSample() const
+    {
+        const auto isFalling = m_SampleNumber++ % FreeFallPeriod < FreeFallSamples;
+        const auto values = std::array<std::int16_t, 6>{
+            0, 0, static_cast<std::int16_t>(isFalling ? 0 : AccelerometerSensitivity),
+            10, -10, 20,
+        };
+
+        auto target = Register::ACCEL_DATA_X1.m_Address;
+        for (const auto value : values)
+        {
+            m_Registers[target++] = static_cast<std::uint8_t>(static_cast<std::uint16_t>(value) >> 8);
+            m_Registers[target++] = static_cast<std::uint8_t>(value);
+        }
+    }
+
+    mutable std::array<std::uint8_t, 256> m_Registers = {};
+    mutable bool m_IsDataReady = false;
+    mutable std::uint64_t m_SampleNumber = 0;
+};
+
+// Serves the registers of a FakeI2c over the protocol of the simulator, on a loopback
+// port of its own, so that SimulatedI2c is tested without the simulator. Serves one
+// connection; the server thread may allocate, it is not the one which is checked.
+class RegisterServer
+{
+public:
+    RegisterServer()
+        : m_Socket{socket(AF_INET, SOCK_STREAM, 0)}
+    {
+        auto address = sockaddr_in{};
+        address.sin_family = AF_INET;
+        address.sin_port = 0;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        auto addressSize = socklen_t{sizeof(address)};
+        if (m_Socket == -1
+            or bind(m_Socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1
+            or listen(m_Socket, 1) == -1
+            or getsockname(m_Socket, reinterpret_cast<sockaddr*>(&address), &addressSize) == -1)
+        {
+            throw std::runtime_error{"Starting the register server failed"};
+        }
+        m_Port = ntohs(address.sin_port);
+
+        m_Thread = std::jthread{[this] { Serve(); }};
+    }
+
+    ~RegisterServer()
+    {
+        // Wakes the server thread if nobody ever connected.
+        shutdown(m_Socket, SHUT_RDWR);
+        m_Thread.join();
+        close(m_Socket);
+    }
+
+    std::string GetEndpoint() const
+    {
+        return std::format("127.0.0.1:{}", m_Port);
+    }
+
+private:
+    void Serve() const
+    {
+        const auto connection = accept(m_Socket, nullptr, nullptr);
+        if (connection == -1)
+        {
+            return;
+        }
+
+        // Requests are null-terminated, and the client waits for the reply before it sends the next one.
+        auto request = std::array<char, 256>{};
+        while (recv(connection, request.data(), request.size() - 1, 0) > 0)
+        {
+            const auto reply = Reply(request.data());
+            send(connection, reply.data(), reply.size(), 0);
+        }
+        close(connection);
+    }
+
+    std::string Reply(const char* request) const
+    {
+        auto address = 0u;
+        auto byte = 0u;
+        if (std::sscanf(request, "READ_BYTE %x", &address) == 1)
+        {
+            return std::format("0x{:02x}", m_Device.ReadByte(0, {static_cast<std::uint8_t>(address)}).readByte);
+        }
+        if (std::sscanf(request, "WRITE_BYTE %x %x", &address, &byte) == 2)
+        {
+            static_cast<void>(m_Device.WriteByte(0, {static_cast<std::uint8_t>(address)}, static_cast<std::uint8_t>(byte)));
+            return "SUCCESS";
+        }
+        return "ERROR: Unknown Command";
+    }
+
+    int m_Socket;
+    std::uint16_t m_Port = 0;
+    FakeI2c m_Device;
+    std::jthread m_Thread;
+};
+
+// Last pipeline stage. Between two of its calls the acquisition thread runs one full
+// iteration of its loop: polling, reading, converting and all the stages before it.
+class AllocationProbe
+{
+public:
+    void Process(const MotionSample&)
+    {
+        // Samples acquired until the driver is stopped are not checked.
+        if (m_NumberOfSamples == NumberOfSamples)
+        {
+            return;
+        }
+
+        const auto allocations = Common::Allocations::CountInCurrentThread();
+        if (m_NumberOfSamples >= WarmUpSamples and allocations != m_LastAllocations)
+        {
+            if (m_NumberOfAllocatingSamples == 0)
+            {
+                m_FirstAllocatingSample = m_NumberOfSamples + 1;
+            }
+            ++m_NumberOfAllocatingSamples;
+        }
+        m_LastAllocations = allocations;
+
+        if (++m_NumberOfSamples == NumberOfSamples)
+        {
+            m_IsDone.store(true, std::memory_order_release);
+            m_IsDone.notify_all();
+        }
+    }
+
+    void WaitUntilDone() const
+    {
+        m_IsDone.wait(false, std::memory_order_acquire);
+    }
+
+    // Valid once done.
+    std::uint64_t GetNumberOfAllocatingSamples() const
+    {
+        return m_NumberOfAllocatingSamples;
+    }
+
+    std::uint64_t GetFirstAllocatingSample() const
+    {
+        return m_FirstAllocatingSample;
+    }
+
+private:
+    std::uint64_t m_NumberOfSamples = 0;
+    std::uint64_t m_LastAllocations = 0;
+    std::uint64_t m_NumberOfAllocatingSamples = 0;
+    std::uint64_t m_FirstAllocatingSample = 0;
+    std::atomic<bool> m_IsDone = false;
+};
+
+bool AcquiresWithoutAllocations(const std::string_view name, Interface::I2c& i2c, VirtualClock& clock)
+{
+    auto imu = ImuDriver{i2c, Interface::I2c::SlaveAddress{0x7F}, clock};
+
+    auto freeFallDetector = FreeFallDetector{};
+    auto blackBoxRecorder = BlackBoxRecorder{clock, BlackBoxConfiguration};
+    auto probe = AllocationProbe{};
+    auto pipeline = Pipeline{freeFallDetector, blackBoxRecorder, probe};
+    imu.SubscribeToNewMotionDataAcquired(pipeline);
+
+    auto freeFallLogger = FreeFallLogger{};
+    freeFallDetector.SubscribeToFreeFallDetection(freeFallLogger);
+    freeFallDetector.SubscribeToFreeFallDetection(blackBoxRecorder);
+
+    if (imu.Initialize() != ImuDriver::Status::Success or imu.Start() != ImuDriver::Status::Success)
+    {
+        std::cerr << std::format("{}: starting the driver failed", name) << std::endl;
+        return false;
+    }
+    probe.WaitUntilDone();
+    if (imu.Stop() != ImuDriver::Status::Success)
+    {
+        std::cerr << std::format("{}: stopping the driver failed", name) << std::endl;
+        return false;
+    }
+
+    if (const auto allocatingSamples = probe.GetNumberOfAllocatingSamples(); allocatingSamples != 0)
+    {
+        std::cerr << std::format("{}: {} of {} samples allocated after warm-up, the first was sample {}", name, allocatingSamples, NumberOfSamples, probe.GetFirstAllocatingSample()) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+int main()
+{
+    auto clock = VirtualClock{};
+    // Acquisition runs at CPU speed and logs every sample, so it would overflow the log queue.
+    Log::Binary::Configure(clock, Log::Binary::OverflowPolicy::Wait);
+
+    auto passed = true;
+    {
+        auto i2c = FakeI2c{};
+        passed &= AcquiresWithoutAllocations("FakeI2c", i2c, clock);
+    }
+    {
+        auto server = RegisterServer{};
+        auto i2c = SimulatedI2c{server.GetEndpoint()};
+        passed &= AcquiresWithoutAllocations("SimulatedI2c", i2c, clock);
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+#include "ImuDriver/Implementation/CalibrationEstimator.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+
+// Feeds synthetic stationary poses of a miscalibrated IMU to CalibrationEstimator and
+// checks the calibration it recovers.
+namespace
+{
+
+constexpr auto SamplesPerPose = 50;
+constexpr auto NoiseAmplitude = 0.002f;
+constexpr auto Tolerance = 1e-3f;
+
+// calibrated = gain * (measured - offset)
+const auto TrueCalibration = ImuCalibration{
+    .accelerometer = {.offset = {0.03f, -0.02f, 0.05f}, .gain = {1.02f, 0.97f, 1.01f}},
+    .gyroscope = {.offset = {0.5f, -1.5f, 2.0f}},
+};
+
+class Device
+{
+public:
+    // Samples of the IMU at rest with the given true gravity vector (in g).
+    void HoldStill(CalibrationEstimator& estimator, const std::array<float, 3>& gravity)
+    {
+        const auto& [accelerometer, gyroscope] = TrueCalibration;
+        for (int n = 0; n < SamplesPerPose; ++n)
+        {
+            auto sample = MotionSample{};
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                sample.acceleration[axis] = gravity[axis] / accelerometer.gain[axis] + accelerometer.offset[axis] + m_Noise(m_Generator);
+                sample.rotation[axis] = gyroscope.offset[axis] + m_Noise(m_Generator);
+            }
+            estimator.Process(sample);
+        }
+    }
+
+private:
+    std::mt19937 m_Generator{42};
+    std::uniform_real_distribution<float> m_Noise{-NoiseAmplitude, NoiseAmplitude};
+};
+
+bool IsClose(const std::string_view name, const std::size_t axis, const float estimated, const float expected)
+{
+    if (std::abs(estimated - expected) > Tolerance)
+    {
+        std::cerr << std::format("{} of axis {} is {}, expected {}", name, axis, estimated, expected) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool RecoversSixPositionCalibration()
+{
+    auto device = Device{};
+    auto estimator = CalibrationEstimator{};
+    estimator.BeginCapture();
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        for (const auto direction : {1.0f, -1.0f})
+        {
+            auto gravity = std::array{0.0f, 0.0f, 0.0f};
+            gravity[axis] = direction;
+            device.HoldStill(estimator, gravity);
+        }
+    }
+    estimator.EndCapture();
+
+    const auto estimate = estimator.GetEstimate();
+    auto passed = true;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        passed &= IsClose("Accelerometer offset", axis, estimate.accelerometer.offset[axis], TrueCalibration.accelerometer.offset[axis]);
+        passed &= IsClose("Accelerometer gain", axis, estimate.accelerometer.gain[axis], TrueCalibration.accelerometer.gain[axis]);
+        passed &= IsClose("Gyroscope offset", axis, estimate.gyroscope.offset[axis], TrueCalibration.gyroscope.offset[axis]);
+    }
+    return passed;
+}
+
+// A single level pose yields the offsets of the horizontal axes only, and the offset of
+// the vertical one assuming unity gain.
+bool RecoversLevelPoseOffsets()
+{
+    auto device = Device{};
+    auto estimator = CalibrationEstimator{};
+    estimator.BeginCapture();
+    device.HoldStill(estimator, {0.0f, 0.0f, 1.0f});
+    estimator.EndCapture();
+
+    const auto estimate = estimator.GetEstimate();
+    const auto& offset = TrueCalibration.accelerometer.offset;
+    const auto verticalOffset = 1.0f / TrueCalibration.accelerometer.gain[2] + offset[2] - 1.0f;
+    return IsClose("Accelerometer offset", 0, estimate.accelerometer.offset[0], offset[0])
+        and IsClose("Accelerometer offset", 1, estimate.accelerometer.offset[1], offset[1])
+        and IsClose("Accelerometer offset", 2, estimate.accelerometer.offset[2], verticalOffset)
+        and IsClose("Accelerometer gain", 2, estimate.accelerometer.gain[2], 1.0f);
+}
+
+bool IgnoresSamplesOutsideCapture()
+{
+    auto device = Device{};
+    auto estimator = CalibrationEstimator{};
+    device.HoldStill(estimator, {0.0f, 0.0f, 1.0f});
+    if (estimator.GetNumberOfStationarySamples() != 0)
+    {
+        std::cerr << "Samples were taken into account outside of a capture" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+int main()
+{
+    auto passed = true;
+    passed &= RecoversSixPositionCalibration();
+    passed &= RecoversLevelPoseOffsets();
+    passed &= IgnoresSamplesOutsideCapture();
+
+    return passed ? 0 : 1;
+}
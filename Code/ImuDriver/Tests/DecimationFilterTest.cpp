@@ -0,0 +1,199 @@
+#include "ImuDriver/Implementation/DecimationFilter.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Checks the SIMD kernels of DecimationFilter against the scalar reference implementation,
+// and the decimation of angular rates fed to it as a pipeline stage.
+namespace
+{
+
+constexpr auto NumberOfInputSamples = std::size_t{4096};
+// Outputs are published in whole blocks only.
+constexpr auto OutputSamplesPerBlock = std::size_t{8};
+constexpr auto FirTolerance = 1e-5f;
+constexpr auto DcGainTolerance = 1e-3f;
+
+class Collector
+    : public Interface::ImuDriver::NewDataAcquiredObserver
+{
+public:
+    std::vector<std::array<float, 3>> samples;
+
+private:
+    void OnNewDataAcquired(const float ax, const float ay, const float az) override
+    {
+        samples.push_back({ax, ay, az});
+    }
+};
+
+class MotionCollector
+    : public Interface::ImuDriver::NewMotionDataAcquiredObserver
+{
+public:
+    std::vector<std::array<float, 6>> samples;
+
+private:
+    void OnNewMotionDataAcquired(const float ax, const float ay, const float az, const float gx, const float gy, const float gz) override
+    {
+        samples.push_back({ax, ay, az, gx, gy, gz});
+    }
+};
+
+std::vector<std::array<float, 3>> Filter(DecimationFilter::Configuration configuration, const DecimationFilter::Kernel kernel, const std::vector<std::array<float, 3>>& input)
+{
+    configuration.kernel = kernel;
+
+    auto filter = DecimationFilter{};
+    if (filter.Configure(configuration) != DecimationFilter::Status::Success)
+    {
+        return {};
+    }
+
+    auto collector = Collector{};
+    filter.SubscribeToNewDataAcquired(collector);
+
+    auto& upstreamObserver = static_cast<Interface::ImuDriver::NewDataAcquiredObserver&>(filter);
+    for (const auto& [ax, ay, az] : input)
+    {
+        upstreamObserver.OnNewDataAcquired(ax, ay, az);
+    }
+
+    return collector.samples;
+}
+
+std::vector<std::array<float, 3>> NoiseAroundGravity()
+{
+    auto generator = std::mt19937{42};
+    auto noise = std::uniform_real_distribution<float>{-2.0f, 2.0f};
+
+    auto input = std::vector<std::array<float, 3>>(NumberOfInputSamples);
+    for (auto& [ax, ay, az] : input)
+    {
+        ax = noise(generator);
+        ay = noise(generator);
+        az = 1.0f + noise(generator);
+    }
+    return input;
+}
+
+bool Compare(const std::string_view name, const DecimationFilter::Configuration& configuration, const std::vector<std::array<float, 3>>& input, const float tolerance)
+{
+    const auto reference = Filter(configuration, DecimationFilter::Kernel::Scalar, input);
+    const auto simd = Filter(configuration, DecimationFilter::Kernel::Simd, input);
+
+    const auto blockSize = OutputSamplesPerBlock * configuration.decimationFactor;
+    const auto expectedSize = input.size() / blockSize * OutputSamplesPerBlock;
+    if (reference.size() != expectedSize or simd.size() != expectedSize)
+    {
+        std::cerr << std::format("{}: expected {} outputs, scalar gave {}, SIMD gave {}", name, expectedSize, reference.size(), simd.size()) << std::endl;
+        return false;
+    }
+
+    for (std::size_t n = 0; n < reference.size(); ++n)
+    {
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            if (std::abs(reference[n][axis] - simd[n][axis]) > tolerance)
+            {
+                std::cerr << std::format("{}: output {} axis {} differs, scalar {} vs SIMD {}", name, n, axis, reference[n][axis], simd[n][axis]) << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool HasUnityDcGain(const std::string_view name, const DecimationFilter::Configuration& configuration)
+{
+    const auto gravity = std::array{0.25f, -0.5f, 1.0f};
+    const auto output = Filter(configuration, DecimationFilter::Kernel::Simd, std::vector(NumberOfInputSamples, gravity));
+    if (output.empty())
+    {
+        std::cerr << std::format("{}: no output", name) << std::endl;
+        return false;
+    }
+
+    // The start-up transient is over by the last output.
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        if (std::abs(output.back()[axis] - gravity[axis]) > DcGainTolerance)
+        {
+            std::cerr << std::format("{}: DC gain on axis {} is {}", name, axis, output.back()[axis] / gravity[axis]) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Constant motion, so every channel has to come out as it went in once the transient is over.
+bool DecimatesAngularRates(const std::string_view name, const DecimationFilter::Configuration& configuration)
+{
+    const auto motion = std::array{0.25f, -0.5f, 1.0f, 10.0f, -250.0f, 100.0f};
+
+    auto filter = DecimationFilter{};
+    filter.Configure(configuration);
+    auto collector = MotionCollector{};
+    filter.SubscribeToNewMotionDataAcquired(collector);
+
+    const auto blockSize = OutputSamplesPerBlock * configuration.decimationFactor;
+    for (std::size_t n = 0; n < NumberOfInputSamples; ++n)
+    {
+        filter.Process({{motion[0], motion[1], motion[2]}, {motion[3], motion[4], motion[5]}});
+
+        // Outputs of a block are published together, once its last input arrived.
+        const auto expectedSize = (n + 1) / blockSize * OutputSamplesPerBlock;
+        if (collector.samples.size() != expectedSize)
+        {
+            std::cerr << std::format("{}: {} outputs after {} inputs, expected {}", name, collector.samples.size(), n + 1, expectedSize) << std::endl;
+            return false;
+        }
+    }
+
+    for (std::size_t channel = 0; channel < motion.size(); ++channel)
+    {
+        if (std::abs(collector.samples.back()[channel] - motion[channel]) > DcGainTolerance * std::abs(motion[channel]))
+        {
+            std::cerr << std::format("{}: DC gain on channel {} is {}", name, channel, collector.samples.back()[channel] / motion[channel]) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+int main()
+{
+    using enum DecimationFilter::Type;
+
+    const auto input = NoiseAroundGravity();
+    auto passed = true;
+    for (const auto decimationFactor : {1, 2, 3, 8})
+    {
+        const auto fir = DecimationFilter::Configuration{.type = FiniteImpulseResponse, .decimationFactor = decimationFactor};
+        const auto cic = DecimationFilter::Configuration{.type = CascadedIntegratorComb, .decimationFactor = decimationFactor};
+        const auto firName = std::format("FIR, decimation {}", decimationFactor);
+        const auto cicName = std::format("CIC, decimation {}", decimationFactor);
+
+        passed &= Compare(firName, fir, input, FirTolerance);
+        // Both CIC kernels work on the same integers, so they have to match exactly.
+        passed &= Compare(cicName, cic, input, 0.0f);
+        passed &= HasUnityDcGain(firName, fir);
+        passed &= HasUnityDcGain(cicName, cic);
+        passed &= DecimatesAngularRates(firName, fir);
+        passed &= DecimatesAngularRates(cicName, cic);
+    }
+
+    std::cout << (passed ? "Scalar and SIMD decimation kernels match" : "Decimation kernel mismatch") << std::endl;
+    return passed ? 0 : 1;
+}
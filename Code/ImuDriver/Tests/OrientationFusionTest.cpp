@@ -0,0 +1,131 @@
+#include "ImuDriver/Implementation/OrientationFusion.hpp"
+#include "ImuDriver/Implementation/Pipeline.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <string_view>
+
+// Feeds synthetic motion of several devices to OrientationFusion, through its pipeline
+// stage, and checks the orientations it estimates.
+namespace
+{
+
+constexpr auto SampleRate = 100.0f;
+constexpr auto Period = 1.0f / SampleRate;
+constexpr auto ConvergenceSteps = 3000;
+constexpr auto Tolerance = 1e-3f;
+
+constexpr auto ComplementaryGain = 2.0f;
+// Madgwick corrects by a step of fixed length, beta * period, so it keeps oscillating
+// around the true orientation by about half of that.
+constexpr auto MadgwickBeta = 0.1f;
+
+// More devices than one SIMD vector holds, so that each lane and the padding are used.
+constexpr auto TiltAngles = std::array{0.0f, 30.0f, -45.0f, 60.0f, 10.0f, -80.0f, 20.0f, 45.0f, -15.0f};
+
+constexpr auto DegreesToRadians = std::numbers::pi_v<float> / 180.0f;
+
+// Orientation reached by rotating from level about the x axis by `angle` degrees.
+OrientationFusion::Quaternion TiltedAboutX(const float angle)
+{
+    const auto halfAngle = angle * DegreesToRadians / 2;
+    return {std::cos(halfAngle), std::sin(halfAngle), 0.0f, 0.0f};
+}
+
+// Gravity measured at rest in that orientation, in g.
+MotionSample AtRestTiltedAboutX(const float angle)
+{
+    return {{0.0f, std::sin(angle * DegreesToRadians), std::cos(angle * DegreesToRadians)}, {0.0f, 0.0f, 0.0f}};
+}
+
+bool IsClose(const std::string_view name, const std::size_t device, const OrientationFusion::Quaternion& estimated, const OrientationFusion::Quaternion& expected)
+{
+    const auto error = std::max({
+        std::abs(estimated.w - expected.w),
+        std::abs(estimated.x - expected.x),
+        std::abs(estimated.y - expected.y),
+        std::abs(estimated.z - expected.z),
+    });
+    if (error > Tolerance)
+    {
+        std::cerr << std::format("{}: device {} is at ({}, {}, {}, {}), expected ({}, {}, {}, {})", name, device,
+            estimated.w, estimated.x, estimated.y, estimated.z, expected.w, expected.x, expected.y, expected.z) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Starting level, every device is held still at its own tilt until the filter settles.
+bool ConvergesAtRest(const std::string_view name, const OrientationFusion::Algorithm algorithm, const float gain)
+{
+    auto fusion = OrientationFusion{TiltAngles.size(), algorithm, gain};
+    for (std::size_t device = 0; device < TiltAngles.size(); ++device)
+    {
+        auto input = OrientationFusion::Input{fusion, device};
+        input.Process(AtRestTiltedAboutX(TiltAngles[device]));
+    }
+
+    for (int step = 0; step < ConvergenceSteps; ++step)
+    {
+        fusion.Step(Period);
+    }
+
+    auto passed = true;
+    for (std::size_t device = 0; device < TiltAngles.size(); ++device)
+    {
+        passed &= IsClose(name, device, fusion.GetOrientation(device), TiltedAboutX(TiltAngles[device]));
+    }
+    return passed;
+}
+
+// Level and turning about the vertical axis at 90 degrees per second for one second. Gravity
+// does not constrain yaw, so the result is the gyroscope integral alone.
+bool IntegratesYawRate(const std::string_view name, const OrientationFusion::Algorithm algorithm, const float gain)
+{
+    constexpr auto yawRate = 90.0f;
+
+    auto fusion = OrientationFusion{1, algorithm, gain};
+    auto input = OrientationFusion::Input{fusion, 0};
+    auto pipeline = Pipeline{input};
+    for (int step = 0; step < static_cast<int>(SampleRate); ++step)
+    {
+        auto sample = MotionSample{{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, yawRate}};
+        pipeline.Process(sample);
+        fusion.Step(Period);
+    }
+
+    const auto halfAngle = std::numbers::pi_v<float> / 4;
+    return IsClose(name, 0, fusion.GetOrientation(0), {std::cos(halfAngle), 0.0f, 0.0f, std::sin(halfAngle)});
+}
+
+bool RejectsInvalidDevice()
+{
+    auto fusion = OrientationFusion{1, OrientationFusion::Algorithm::Complementary, ComplementaryGain};
+    if (fusion.SetInput(1, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f) != OrientationFusion::Status::InvalidDevice)
+    {
+        std::cerr << "Input for a device out of range was accepted" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+int main()
+{
+    auto passed = true;
+    passed &= ConvergesAtRest("Complementary at rest", OrientationFusion::Algorithm::Complementary, ComplementaryGain);
+    passed &= ConvergesAtRest("Madgwick at rest", OrientationFusion::Algorithm::Madgwick, MadgwickBeta);
+    passed &= IntegratesYawRate("Complementary yaw", OrientationFusion::Algorithm::Complementary, ComplementaryGain);
+    passed &= IntegratesYawRate("Madgwick yaw", OrientationFusion::Algorithm::Madgwick, MadgwickBeta);
+    passed &= RejectsInvalidDevice();
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include "ImuDriver/Implementation/SpectralAnalyzer.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <numbers>
+#include <string_view>
+
+// Checks that gravity does not leak into the spectrum and that vibrations are still found.
+namespace
+{
+
+constexpr auto NumberOfInputSamples = std::size_t{1024};
+constexpr auto DcTolerance = 1e-3f;
+constexpr auto AmplitudeTolerance = 0.02f;
+
+// Integer frequencies fall exactly on DFT bins, so there is no scalloping loss.
+const auto OnGridConfiguration = SpectralAnalyzer::Configuration{
+    .sampleRate = 64.0f,
+    .windowSize = 64,
+    .hopSize = 16,
+    .binFrequencies = {1.0f, 2.0f, 4.0f, 8.0f, 12.0f, 16.0f, 20.0f, 24.0f},
+};
+
+SpectralAnalyzer::Spectrum Analyze(const SpectralAnalyzer::Configuration& configuration, const std::function<std::array<float, 3>(float)>& signal)
+{
+    auto analyzer = SpectralAnalyzer{};
+    if (analyzer.Configure(configuration) != SpectralAnalyzer::Status::Success)
+    {
+        return {};
+    }
+
+    auto& upstreamObserver = static_cast<Interface::ImuDriver::NewDataAcquiredObserver&>(analyzer);
+    for (std::size_t n = 0; n < NumberOfInputSamples; ++n)
+    {
+        const auto [ax, ay, az] = signal(static_cast<float>(n) / configuration.sampleRate);
+        upstreamObserver.OnNewDataAcquired(ax, ay, az);
+    }
+
+    return analyzer.GetSpectrum();
+}
+
+bool IsFlat(const std::string_view name, const SpectralAnalyzer::Spectrum& spectrum, const std::size_t axis)
+{
+    for (std::size_t bin = 0; bin < spectrum.numberOfBins; ++bin)
+    {
+        if (spectrum.amplitude[axis][bin] > DcTolerance)
+        {
+            std::cerr << std::format("{}: axis {} has {} g in bin {}", name, axis, spectrum.amplitude[axis][bin], bin) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ConstantGivesNoAmplitudes(const std::string_view name, const SpectralAnalyzer::Configuration& configuration)
+{
+    const auto spectrum = Analyze(configuration, [](float) { return std::array{0.2f, -0.5f, 1.0f}; });
+    if (spectrum.windowNumber == 0)
+    {
+        std::cerr << std::format("{}: no spectrum", name) << std::endl;
+        return false;
+    }
+
+    auto passed = true;
+    for (std::size_t axis = 0; axis < 3; ++axis)
+    {
+        passed &= IsFlat(name, spectrum, axis);
+    }
+    return passed;
+}
+
+bool FindsVibrationOnGravity()
+{
+    constexpr auto name = std::string_view{"Vibration on gravity"};
+    constexpr auto frequency = 8.0f;
+    constexpr auto amplitude = 0.3f;
+    constexpr auto vibrationBin = std::size_t{3};
+
+    const auto spectrum = Analyze(OnGridConfiguration, [](const float time)
+    {
+        return std::array{amplitude * std::sin(2 * std::numbers::pi_v<float> * frequency * time), 0.2f, 1.0f};
+    });
+
+    if (spectrum.dominantFrequency[0] != frequency)
+    {
+        std::cerr << std::format("{}: dominant frequency is {} Hz", name, spectrum.dominantFrequency[0]) << std::endl;
+        return false;
+    }
+    if (std::abs(spectrum.amplitude[0][vibrationBin] - amplitude) > AmplitudeTolerance * amplitude)
+    {
+        std::cerr << std::format("{}: amplitude is {} g", name, spectrum.amplitude[0][vibrationBin]) << std::endl;
+        return false;
+    }
+
+    return IsFlat(name, spectrum, 1) and IsFlat(name, spectrum, 2);
+}
+
+}
+
+int main()
+{
+    auto passed = true;
+    passed &= ConstantGivesNoAmplitudes("Constant, default configuration", SpectralAnalyzer::Configuration{});
+    passed &= ConstantGivesNoAmplitudes("Constant, on-grid configuration", OnGridConfiguration);
+    passed &= FindsVibrationOnGravity();
+
+    return passed ? 0 : 1;
+}
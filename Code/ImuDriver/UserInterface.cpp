@@ -1,9 +1,12 @@
 #include "ImuDriver/View/UserInterface.hpp"
 
+#include "ImuDriver/Common/BinaryLogger.hpp"
 #include "ImuDriver/Common/Logger.hpp"
 
+#include "ImuDriver/Implementation/CalibrationEstimator.hpp"
 #include "ImuDriver/Implementation/ImuDriver.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <iostream>
@@ -16,12 +19,16 @@ namespace Command
 
 constexpr auto StartAcquisition = std::string{"start"};
 constexpr auto StopAcquisition = std::string{"stop"};
+constexpr auto ShowLatestSample = std::string{"show"};
+constexpr auto StartCalibration = std::string{"calibrate"};
+constexpr auto SaveCalibration = std::string{"save"};
 constexpr auto Exit = std::string{"exit"};
 
 }
 
-UserInterface::UserInterface(ImuDriver& imu)
+UserInterface::UserInterface(ImuDriver& imu, CalibrationEstimator& calibrationEstimator)
     : m_Imu{imu}
+    , m_CalibrationEstimator{calibrationEstimator}
 {
 }
 
@@ -29,6 +36,8 @@ UserInterface::Status UserInterface::RunMainLoop()
 {
     std::cout << "Run following command in separate terminal to track logs:" << std::endl;
     std::cout << "tail -f " << std::filesystem::current_path() / Log::FileName << std::endl;
+    std::cout << "Acquired samples are logged in binary form, decode them with:" << std::endl;
+    std::cout << "ImuLogDecoder " << std::filesystem::current_path() / Log::Binary::FileName << std::endl;
     std::cout << std::endl;
 
     std::cout << "Initializing the IMU (please make sure that IMU simulator is turned on)..." << std::endl;
@@ -51,7 +60,13 @@ UserInterface::Status UserInterface::RunMainLoop()
         else
         {
             std::cout << std::format("{} -- to TURN ON data acquisition", Command::StartAcquisition) << std::endl;
+            std::cout << std::format("{} -- to TURN ON data acquisition and estimate calibration", Command::StartCalibration) << std::endl;
         }
+        if (m_CalibrationEstimator.IsCapturing())
+        {
+            std::cout << std::format("{} -- to TURN OFF data acquisition, apply and save the estimated calibration", Command::SaveCalibration) << std::endl;
+        }
+        std::cout << std::format("{} -- to show the latest acquired sample", Command::ShowLatestSample) << std::endl;
         std::cout << std::format("{} -- to close the application", Command::Exit) << std::endl;
         std::cout << std::endl;
         std::cout << "What to do: " << std::flush;
@@ -69,6 +84,7 @@ UserInterface::Status UserInterface::RunMainLoop()
                 return Status::UnknownError;
             }
             Log::Info("IMU data acquisition started");
+            ShowThreadConfigurationResult();
         }
         else if (input == Command::StopAcquisition and m_Imu.IsDataAcquisitionEnabled())
         {
@@ -78,6 +94,30 @@ UserInterface::Status UserInterface::RunMainLoop()
                 return Status::UnknownError;
             }
             Log::Info("IMU data acquisition stopped");
+            ShowJitterStatistics();
+            if (m_CalibrationEstimator.IsCapturing())
+            {
+                m_CalibrationEstimator.EndCapture();
+                Log::Info("IMU calibration cancelled");
+            }
+        }
+        else if (input == Command::StartCalibration and not m_Imu.IsDataAcquisitionEnabled())
+        {
+            if (StartCalibration() != Status::Success)
+            {
+                return Status::UnknownError;
+            }
+        }
+        else if (input == Command::SaveCalibration and m_CalibrationEstimator.IsCapturing())
+        {
+            if (SaveCalibration() != Status::Success)
+            {
+                return Status::UnknownError;
+            }
+        }
+        else if (input == Command::ShowLatestSample)
+        {
+            ShowLatestSample();
         }
         else if (input == Command::Exit)
         {
@@ -96,4 +136,116 @@ UserInterface::Status UserInterface::RunMainLoop()
     return Status::Success;
 }
 
+// The estimator works on uncalibrated samples, so the current calibration is dropped
+// until the new one is saved.
+UserInterface::Status UserInterface::StartCalibration()
+{
+    if (m_Imu.SetCalibration(ImuCalibration{}) != ImuDriver::Status::Success)
+    {
+        Log::Error("IMU calibration reset failed");
+        return Status::UnknownError;
+    }
+
+    m_CalibrationEstimator.BeginCapture();
+    if (m_Imu.Start() != ImuDriver::Status::Success)
+    {
+        m_CalibrationEstimator.EndCapture();
+        Log::Error("IMU data acquisition start failed");
+        return Status::UnknownError;
+    }
+    Log::Info("IMU data acquisition started for calibration");
+    ShowThreadConfigurationResult();
+
+    std::cout << std::endl;
+    std::cout << "Hold the IMU still, with each axis pointing up and then down in turn," << std::endl;
+    std::cout << std::format("for at least a second per pose, then type \"{}\".", Command::SaveCalibration) << std::endl;
+    std::cout << std::endl;
+    return Status::Success;
+}
+
+UserInterface::Status UserInterface::SaveCalibration()
+{
+    if (m_Imu.Stop() != ImuDriver::Status::Success)
+    {
+        Log::Error("IMU data acquisition stop failed");
+        return Status::UnknownError;
+    }
+    Log::Info("IMU data acquisition stopped");
+    ShowJitterStatistics();
+    m_CalibrationEstimator.EndCapture();
+
+    const auto calibration = m_CalibrationEstimator.GetEstimate();
+    if (m_Imu.SetCalibration(calibration) != ImuDriver::Status::Success)
+    {
+        Log::Error("Applying IMU calibration failed");
+        return Status::UnknownError;
+    }
+
+    if (calibration.Save(ImuCalibration::FileName) != ImuCalibration::Status::Success)
+    {
+        Log::Error(std::format("Saving IMU calibration to {} failed", ImuCalibration::FileName));
+        return Status::UnknownError;
+    }
+    Log::Info(std::format("IMU calibration from {} stationary samples saved to {}", m_CalibrationEstimator.GetNumberOfStationarySamples(), ImuCalibration::FileName));
+    return Status::Success;
+}
+
+void UserInterface::ShowLatestSample() const
+{
+    const auto sample = m_Imu.GetLatestSample();
+
+    std::cout << std::endl;
+    if (sample.sampleNumber == 0)
+    {
+        std::cout << "No sample acquired yet" << std::endl;
+    }
+    else
+    {
+        const auto& [ax, ay, az] = sample.acceleration;
+        const auto& [gx, gy, gz] = sample.rotation;
+        const auto timestamp = std::chrono::duration<double>{sample.timestamp.time_since_epoch()};
+        std::cout << std::format("Sample {} at {:.3f} s (after {} data ready polls):", sample.sampleNumber, timestamp.count(), sample.numberOfDataReadyPolls) << std::endl;
+        std::cout << std::format("ax={: .3f} g, ay={: .3f} g, az={: .3f} g", ax, ay, az) << std::endl;
+        std::cout << std::format("gx={: .3f} dps, gy={: .3f} dps, gz={: .3f} dps", gx, gy, gz) << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Settings the system refused are logged by the driver; the console only gets a hint.
+void UserInterface::ShowThreadConfigurationResult() const
+{
+    const auto [affinityGranted, schedulingGranted, memoryLocked] = m_Imu.GetThreadConfigurationResult();
+    if (affinityGranted and schedulingGranted and memoryLocked)
+    {
+        return;
+    }
+
+    std::cout << std::endl;
+    std::cout << std::format("Warning: data acquisition thread runs without{}{}{}, see {}",
+        affinityGranted ? "" : " CPU affinity",
+        schedulingGranted ? "" : " real-time scheduling",
+        memoryLocked ? "" : " locked memory",
+        Log::FileName) << std::endl;
+    std::cout << std::endl;
+}
+
+// Only measured when the driver was started with --measure-jitter.
+void UserInterface::ShowJitterStatistics() const
+{
+    const auto jitter = m_Imu.GetJitterStatistics();
+    if (jitter.numberOfWakeUps == 0)
+    {
+        return;
+    }
+
+    using Microseconds = std::chrono::duration<double, std::micro>;
+    std::cout << std::endl;
+    std::cout << std::format("Wake-up latency over {} polls: min={:.1f} us, mean={:.1f} us, max={:.1f} us",
+        jitter.numberOfWakeUps,
+        Microseconds{jitter.minimum}.count(),
+        Microseconds{jitter.total / jitter.numberOfWakeUps}.count(),
+        Microseconds{jitter.maximum}.count()) << std::endl;
+    std::cout << std::endl;
+}
+
 }
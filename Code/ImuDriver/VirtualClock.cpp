@@ -0,0 +1,20 @@
+#include "ImuDriver/Implementation/VirtualClock.hpp"
+
+VirtualClock::TimePoint VirtualClock::Now() const
+{
+    return TimePoint{Duration{m_Now.load(std::memory_order_acquire)}};
+}
+
+void VirtualClock::SleepFor(const Duration duration)
+{
+    m_Now.fetch_add(duration.count(), std::memory_order_acq_rel);
+}
+
+void VirtualClock::AdvanceTo(const TimePoint timePoint)
+{
+    const auto target = timePoint.time_since_epoch().count();
+    auto now = m_Now.load(std::memory_order_acquire);
+    while (now < target and not m_Now.compare_exchange_weak(now, target, std::memory_order_acq_rel))
+    {
+    }
+}
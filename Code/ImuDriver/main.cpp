@@ -1,25 +1,178 @@
+#include "ImuDriver/Implementation/BlackBoxRecorder.hpp"
+#include "ImuDriver/Implementation/Calibration.hpp"
+#include "ImuDriver/Implementation/CalibrationEstimator.hpp"
 #include "ImuDriver/Implementation/FreeFallDetector.hpp"
 #include "ImuDriver/Implementation/FreeFallLogger.hpp"
 #include "ImuDriver/Implementation/ImuDriver.hpp"
+#include "ImuDriver/Implementation/Pipeline.hpp"
 #include "ImuDriver/Implementation/SimulatedI2c.hpp"
+#include "ImuDriver/Implementation/SystemClock.hpp"
+#include "ImuDriver/Implementation/VirtualClock.hpp"
 
 #include "ImuDriver/View/UserInterface.hpp"
 
+#include "ImuDriver/Common/BinaryLogger.hpp"
+#include "ImuDriver/Common/Logger.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string_view>
+
+using Interface::Clock;
 using Interface::I2c;
 
+namespace
+{
+
+// Use together with the simulator's --virtual-time option to replay data at CPU speed.
+constexpr auto VirtualTimeOption = std::string_view{"--virtual-time"};
+
+// Real-time settings of the data acquisition thread, see ImuDriver::ThreadConfiguration.
+constexpr auto CpuOption = std::string_view{"--cpu="};
+constexpr auto SchedulingOption = std::string_view{"--scheduling="};
+constexpr auto PriorityOption = std::string_view{"--priority="};
+constexpr auto LockMemoryOption = std::string_view{"--lock-memory"};
+constexpr auto PrefaultStackOption = std::string_view{"--prefault-stack="};
+constexpr auto MeasureJitterOption = std::string_view{"--measure-jitter"};
+
+constexpr auto FifoScheduling = std::string_view{"fifo"};
+constexpr auto RoundRobinScheduling = std::string_view{"round-robin"};
+
+constexpr auto Usage =
+    "Usage: ImuDriver [--virtual-time] [--cpu=N] [--scheduling=fifo|round-robin --priority=N]\n"
+    "                 [--lock-memory] [--prefault-stack=BYTES] [--measure-jitter]";
+
+struct Options
+{
+    bool useVirtualTime = false;
+    ImuDriver::ThreadConfiguration threadConfiguration;
+};
+
+template<typename T>
+bool ParseNumber(const std::string_view text, T& value)
+{
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc{} and end == text.data() + text.size();
+}
+
+std::optional<Options> ParseOptions(const std::span<char*> arguments)
+{
+    using enum ImuDriver::ThreadConfiguration::SchedulingPolicy;
+
+    auto options = Options{};
+    auto& thread = options.threadConfiguration;
+    for (const std::string_view argument : arguments)
+    {
+        auto isValid = true;
+        if (argument == VirtualTimeOption)
+        {
+            options.useVirtualTime = true;
+        }
+        else if (argument == LockMemoryOption)
+        {
+            thread.lockMemory = true;
+        }
+        else if (argument == MeasureJitterOption)
+        {
+            thread.measureJitter = true;
+        }
+        else if (argument.starts_with(CpuOption))
+        {
+            auto cpu = 0;
+            isValid = ParseNumber(argument.substr(CpuOption.size()), cpu);
+            thread.cpu = cpu;
+        }
+        else if (argument.starts_with(SchedulingOption))
+        {
+            const auto policy = argument.substr(SchedulingOption.size());
+            isValid = policy == FifoScheduling or policy == RoundRobinScheduling;
+            thread.schedulingPolicy = policy == FifoScheduling ? Fifo : RoundRobin;
+        }
+        else if (argument.starts_with(PriorityOption))
+        {
+            isValid = ParseNumber(argument.substr(PriorityOption.size()), thread.priority);
+        }
+        else if (argument.starts_with(PrefaultStackOption))
+        {
+            isValid = ParseNumber(argument.substr(PrefaultStackOption.size()), thread.prefaultedStackSize);
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if (not isValid)
+        {
+            std::cerr << std::format("Invalid option: {}", argument) << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    return options;
+}
+
+// Two seconds before and one second after free fall detection, at the 50 Hz output data rate.
+constexpr auto BlackBoxConfiguration = BlackBoxRecorder::Configuration{
+    .preTriggerSamples = 100,
+    .postTriggerSamples = 50,
+};
+
+}
+
 int main(int argc, char *argv[])
 {
+    const auto options = ParseOptions({argv + 1, static_cast<std::size_t>(argc - 1)});
+    if (not options)
+    {
+        std::cerr << Usage << std::endl;
+        return 1;
+    }
+
     auto i2c = SimulatedI2c{""};
     const auto slave = I2c::SlaveAddress{0x7F};
 
-    auto imu = ImuDriver{i2c, slave};
+    auto systemClock = SystemClock{};
+    auto virtualClock = VirtualClock{};
+    const auto useVirtualTime = options->useVirtualTime;
+    Clock& clock = useVirtualTime ? static_cast<Clock&>(virtualClock) : systemClock;
+    // Virtual time acquires samples faster than logs can be written; wait for the writer rather than drop records.
+    Log::Binary::Configure(clock, useVirtualTime ? Log::Binary::OverflowPolicy::Wait : Log::Binary::OverflowPolicy::Drop);
+
+    auto imu = ImuDriver{i2c, slave, clock};
+    if (imu.SetThreadConfiguration(options->threadConfiguration) != ImuDriver::Status::Success)
+    {
+        std::cerr << "Invalid data acquisition thread configuration, see " << Log::FileName << std::endl;
+        return 1;
+    }
+
+    if (std::filesystem::exists(ImuCalibration::FileName))
+    {
+        const auto [status, calibration] = ImuCalibration::Load(ImuCalibration::FileName);
+        if (status != ImuCalibration::Status::Success)
+        {
+            Log::Error("Loading IMU calibration failed");
+            return 1;
+        }
+        imu.SetCalibration(calibration);
+        Log::Info("IMU calibration loaded");
+    }
 
+    // The processing chain is fixed, so it is composed at compile time rather than wired through observers.
     auto freeFallDetector = FreeFallDetector{};
-    imu.SubscribeToNewDataAcquired(freeFallDetector);
+    auto blackBoxRecorder = BlackBoxRecorder{clock, BlackBoxConfiguration};
+    auto calibrationEstimator = CalibrationEstimator{};
+    auto pipeline = Pipeline{freeFallDetector, blackBoxRecorder, calibrationEstimator};
+    imu.SubscribeToNewMotionDataAcquired(pipeline);
 
     auto freeFallLogger = FreeFallLogger{};
     freeFallDetector.SubscribeToFreeFallDetection(freeFallLogger);
+    freeFallDetector.SubscribeToFreeFallDetection(blackBoxRecorder);
 
-    auto userInterface = View::UserInterface{imu};
+    auto userInterface = View::UserInterface{imu, calibrationEstimator};
     return static_cast<int>(userInterface.RunMainLoop());
 }
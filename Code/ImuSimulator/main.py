@@ -1,3 +1,4 @@
+import argparse
 from collections.abc import Iterator
 import csv
 import itertools
@@ -20,17 +21,54 @@ class Registers:
     ACCEL_DATA_Y0 = 0x0E
     ACCEL_DATA_Z1 = 0x0F
     ACCEL_DATA_Z0 = 0x10
+    GYRO_DATA_X1 = 0x11
+    GYRO_DATA_X0 = 0x12
+    GYRO_DATA_Y1 = 0x13
+    GYRO_DATA_Y0 = 0x14
+    GYRO_DATA_Z1 = 0x15
+    GYRO_DATA_Z0 = 0x16
     PWR_MGMT0 = 0x1F
+    GYRO_CONFIG0 = 0x20
     ACCEL_CONFIG0 = 0x21
     INT_STATUS_DRDY = 0x39
 
 
+class WallClock:
+    """Real time, as seen by the physical IMU."""
+
+    def now(self) -> float:
+        return time.time()
+
+    def skip_to(self, timepoint: float) -> None:
+        """Real time cannot be skipped, the caller has to poll until the timepoint passes."""
+
+
+class VirtualClock:
+    """Simulated time which jumps directly to the next event, so data is replayed at CPU speed."""
+
+    def __init__(self):
+        self.__now = 0.0
+
+    def now(self) -> float:
+        return self.__now
+
+    def skip_to(self, timepoint: float) -> None:
+        self.__now = max(self.__now, timepoint)
+
+
+Clock = WallClock | VirtualClock
+
+
 class ImuDataProvider:
     Time = float
 
-    def __init__(self, output_data_rate: Time, data_source_path: str | Path):
-        self.__last_query = self.__now()
-        self.__output_data_rate = output_data_rate
+    # LSB per g for each ACCEL_UI_FS_SEL value: ±16 g, ±8 g, ±4 g and ±2 g.
+    ACCELERATION_SENSITIVITIES = {0: 2048, 1: 4096, 2: 8192, 3: 16384}
+
+    def __init__(self, output_data_period: Time, data_source_path: str | Path, clock: Clock):
+        self.__clock = clock
+        self.__output_data_period = output_data_period
+        self.__acceleration_sensitivity = ImuDataProvider.ACCELERATION_SENSITIVITIES[0]
         self.__timepoint_of_last_data_acquisition: ImuDataProvider.Time | None = None
         self.__acquired_data = {
             Registers.ACCEL_DATA_X1: 0xAA,
@@ -39,6 +77,12 @@ class ImuDataProvider:
             Registers.ACCEL_DATA_Y0: 0xDD,
             Registers.ACCEL_DATA_Z1: 0xEE,
             Registers.ACCEL_DATA_Z0: 0xFF,
+            Registers.GYRO_DATA_X1: 0xAA,
+            Registers.GYRO_DATA_X0: 0xBB,
+            Registers.GYRO_DATA_Y1: 0xCC,
+            Registers.GYRO_DATA_Y0: 0xDD,
+            Registers.GYRO_DATA_Z1: 0xEE,
+            Registers.GYRO_DATA_Z0: 0xFF,
         }
 
         def update_data_in_registers() -> Iterator[None]:
@@ -46,20 +90,38 @@ class ImuDataProvider:
                 data_source = csv.reader(data_source_file)
                 next(data_source)  # Skip header.
                 for row in itertools.cycle(data_source):
-                    row = [self.__convert_acceleration_to_binary(float(value)) for value in row[:3]]
+                    # Converted only when the sample is acquired, so range changes apply from the next sample on.
+                    row = (
+                        [self.__convert_acceleration_to_binary(float(value)) for value in row[:3]] +
+                        [self.__convert_rotation_to_binary(float(value)) for value in row[3:6]]
+                    )
                     debug_print(f"New acquired data: {row}")
-                    self.__acquired_data[Registers.ACCEL_DATA_X1] = int(row[0][:2], 16)
-                    self.__acquired_data[Registers.ACCEL_DATA_X0] = int(row[0][2:], 16)
-                    self.__acquired_data[Registers.ACCEL_DATA_Y1] = int(row[1][:2], 16)
-                    self.__acquired_data[Registers.ACCEL_DATA_Y0] = int(row[1][2:], 16)
-                    self.__acquired_data[Registers.ACCEL_DATA_Z1] = int(row[2][:2], 16)
-                    self.__acquired_data[Registers.ACCEL_DATA_Z0] = int(row[2][2:], 16)
+                    # Data registers are consecutive, high byte first, starting with ACCEL_DATA_X1.
+                    for index, value in enumerate(row):
+                        self.__acquired_data[Registers.ACCEL_DATA_X1 + 2 * index] = int(value[:2], 16)
+                        self.__acquired_data[Registers.ACCEL_DATA_X1 + 2 * index + 1] = int(value[2:], 16)
                     yield
 
         self.__update_data_in_registers_iterator = update_data_in_registers()
 
+    def set_acceleration_full_scale(self, full_scale_selection: int) -> None:
+        self.__acceleration_sensitivity = ImuDataProvider.ACCELERATION_SENSITIVITIES[full_scale_selection]
+
+    def set_output_data_period(self, output_data_period: Time) -> None:
+        """The next sample is acquired one new period after the last one."""
+        self.__output_data_period = output_data_period
+
     def __convert_acceleration_to_binary(self, value: float) -> str:
-        return f"{(int(value * 16384) & 0xFFFF):04x}"
+        return self.__convert_to_binary(value * self.__acceleration_sensitivity)
+
+    def __convert_rotation_to_binary(self, value: float) -> str:
+        """Angular rate in dps, for the ±250 dps full scale range."""
+        return self.__convert_to_binary(value * 131)
+
+    @staticmethod
+    def __convert_to_binary(value: float) -> str:
+        """Saturates like the sensor does when the value is out of the full scale range."""
+        return f"{(min(max(int(value), -32768), 32767) & 0xFFFF):04x}"
 
     def update_data_in_registers(self) -> None:
         next(self.__update_data_in_registers_iterator)
@@ -68,7 +130,8 @@ class ImuDataProvider:
         """This mimics the behavior of INT_STATUS_DRDY in real IMU device."""
 
         timepoint_of_next_data_acquisition = self.__timepoint_of_next_data_acquisition()
-        is_new_data_acquired = timepoint_of_next_data_acquisition < self.__now()
+        self.__clock.skip_to(timepoint_of_next_data_acquisition)
+        is_new_data_acquired = timepoint_of_next_data_acquisition <= self.__now()
         if is_new_data_acquired:
             self.update_data_in_registers()
             self.__timepoint_of_last_data_acquisition = timepoint_of_next_data_acquisition
@@ -78,7 +141,7 @@ class ImuDataProvider:
         return self.__acquired_data[register]
 
     def __timepoint_of_next_data_acquisition(self) -> Time:
-        return self.__timepoint_of_last_data_acquisition + self.__output_data_rate
+        return self.__timepoint_of_last_data_acquisition + self.__output_data_period
 
     def enable(self) -> None:
         self.__timepoint_of_last_data_acquisition = self.__now()
@@ -88,24 +151,30 @@ class ImuDataProvider:
         self.__timepoint_of_last_data_acquisition = None
         print("Data acquisition disabled")
 
-    @staticmethod
-    def __now() -> Time:
-        return time.time()
+    def __now(self) -> Time:
+        return self.__clock.now()
 
 
 class ImuSimulator:
+    ACCEL_UI_FS_SEL_OFFSET = 5
+    ACCEL_UI_FS_SEL_MASK = 0x03 << ACCEL_UI_FS_SEL_OFFSET
+    ACCEL_ODR_MASK = 0x0F
+    # Output data period in seconds for each ACCEL_ODR value, from 1.6 kHz down to 1.5625 Hz.
+    ACCEL_ODR_PERIODS = {selection: 2 ** (selection - 5) / 1600 for selection in range(5, 16)}
     ACCEL_MODE_MASK = 0x03
     ACCEL_MODE_DISABLED = 0x00
     ACCEL_MODE_LOW_NOISE = 0x03
 
-    def __init__(self):
+    def __init__(self, clock: Clock):
         self.__registers = {
             Registers.PWR_MGMT0: 0x00,
+            Registers.GYRO_CONFIG0: 0x06,
             Registers.ACCEL_CONFIG0: 0x06,
         }
         self.__data_provider = ImuDataProvider(
-            0.04,  # for tests: 0.04 seconds, 25 Hz
-            "../../TestData/ImuLog.csv"
+            self.__output_data_period(self.__registers[Registers.ACCEL_CONFIG0]),
+            "../../TestData/ImuLog.csv",
+            clock
         )
 
     def read_from_register(self, register: int) -> int:
@@ -113,7 +182,7 @@ class ImuSimulator:
             return self.__registers[register]
         elif register == Registers.INT_STATUS_DRDY:
             return 0x01 if self.__data_provider.is_new_data_ready() else 0x00
-        elif Registers.ACCEL_DATA_X1 <= register <= Registers.ACCEL_DATA_Z0:
+        elif Registers.ACCEL_DATA_X1 <= register <= Registers.GYRO_DATA_Z0:
             return self.__data_provider.get_acquired_data_for_register(register)
         else:
             return 0xab
@@ -124,6 +193,11 @@ class ImuSimulator:
 
         if register == Registers.ACCEL_CONFIG0:
             print(f"ACCEL_CONFIG0 set to 0x{value:02x}")
+            full_scale_selection = (value & self.ACCEL_UI_FS_SEL_MASK) >> self.ACCEL_UI_FS_SEL_OFFSET
+            self.__data_provider.set_acceleration_full_scale(full_scale_selection)
+            self.__data_provider.set_output_data_period(self.__output_data_period(value))
+        elif register == Registers.GYRO_CONFIG0:
+            print(f"GYRO_CONFIG0 set to 0x{value:02x}")
         elif register == Registers.PWR_MGMT0:
             print(f"PWR_MGMT0 set to 0x{value:02x}")
             accel_mode_value = value & self.ACCEL_MODE_MASK
@@ -135,6 +209,14 @@ class ImuSimulator:
                 raise RuntimeError(f"Unsupported value of ACCEL_MODE (PWR_MGMT0 register) received: 0x{accel_mode_value:02x}")
 
 
+    @classmethod
+    def __output_data_period(cls, accel_config0: int) -> ImuDataProvider.Time:
+        output_data_rate_selection = accel_config0 & cls.ACCEL_ODR_MASK
+        if output_data_rate_selection not in cls.ACCEL_ODR_PERIODS:
+            raise RuntimeError(f"Unsupported value of ACCEL_ODR (ACCEL_CONFIG0 register) received: 0x{output_data_rate_selection:02x}")
+        return cls.ACCEL_ODR_PERIODS[output_data_rate_selection]
+
+
 class I2cSimulator:
     __READ_BYTE = "READ_BYTE"
     __WRITE_BYTE = "WRITE_BYTE"
@@ -176,12 +258,21 @@ class I2cSimulator:
 
 
 def main() -> None:
+    parser = argparse.ArgumentParser(description="Simulates an IMU connected over I2C")
+    parser.add_argument(
+        "--virtual-time",
+        action="store_true",
+        help="do not wait for real time to pass, report every sample as soon as it is polled"
+    )
+    arguments = parser.parse_args()
+    clock = VirtualClock() if arguments.virtual_time else WallClock()
+
     s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
     s.bind(("localhost", 5555))
     s.listen()
     conn, addr = s.accept()
 
-    i2c = I2cSimulator(ImuSimulator())
+    i2c = I2cSimulator(ImuSimulator(clock))
     while True:
         # Wait for next request from client
         message = conn.recv(1024)[:-1]